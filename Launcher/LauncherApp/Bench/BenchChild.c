@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "Ipc.h"
+
+// Synthetic output source for BenchDriver. Writes lines of a fixed size to stdout, each
+// starting with the QueryPerformanceCounter value at the time it was written:
+//
+//   <16 hex digit QPC> <sequence number> <padding>\n
+//
+// QPC is system wide, so the driver can subtract it from its own clock to get the delivery
+// latency of every line.
+//
+//   bench_child.exe [--lines N] [--size BYTES] [--rate LINES_PER_SECOND] [--framed]
+//
+// A rate of 0 writes as fast as the pipe accepts. --framed wraps every line in an IPC frame
+// on the LOG channel, like Launcher.py does with --framed-ipc.
+
+// Shortest line that still holds the timestamp, a sequence number and the newline
+#define MIN_LINE_SIZE 32
+
+int main(int argc, char *argv[])
+{
+    DWORD lines = 100000;
+    DWORD size = 100;
+    DWORD rate = 0;
+    BOOL framed = FALSE;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--lines") == 0 && i + 1 < argc)
+            lines = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            size = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            rate = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--framed") == 0)
+            framed = TRUE;
+        else
+        {
+            fprintf(stderr, "[ERROR] Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (size < MIN_LINE_SIZE)
+        size = MIN_LINE_SIZE;
+    if (size > IPC_MAX_PAYLOAD)
+        size = IPC_MAX_PAYLOAD;
+
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    char *line = (char *)malloc(size);
+    char *frame = (char *)malloc(size + IPC_FRAME_HEADER_SIZE);
+    if (!line || !frame)
+    {
+        fprintf(stderr, "[ERROR] Out of memory.\n");
+        return 1;
+    }
+    memset(line, 'x', size);
+    line[size - 1] = '\n';
+
+    LARGE_INTEGER frequency, start, now;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+
+    for (DWORD sequence = 0; sequence < lines; sequence++)
+    {
+        // Pace against the start time rather than the previous line so the rate does not drift
+        if (rate)
+        {
+            LONGLONG due = start.QuadPart + (LONGLONG)sequence * frequency.QuadPart / rate;
+            for (;;)
+            {
+                QueryPerformanceCounter(&now);
+                LONGLONG ahead = due - now.QuadPart;
+                if (ahead <= 0)
+                    break;
+                // Sleep while more than 2 ms ahead, spin for the rest
+                if (ahead * 1000 > 2 * frequency.QuadPart)
+                    Sleep(1);
+            }
+        }
+
+        QueryPerformanceCounter(&now);
+        char stamp[MIN_LINE_SIZE];
+        int stampLength = snprintf(stamp, sizeof(stamp), "%016llx %lu ",
+                                   (unsigned long long)now.QuadPart, sequence);
+        memcpy(line, stamp, stampLength);
+
+        const char *data = line;
+        DWORD length = size;
+        if (framed)
+        {
+            length = ipcEncodeFrame(IPC_CHANNEL_LOG, line, size, frame, size + IPC_FRAME_HEADER_SIZE);
+            data = frame;
+        }
+
+        DWORD written;
+        if (!WriteFile(output, data, length, &written, NULL) || written != length)
+        {
+            fprintf(stderr, "[ERROR] Write failed after %lu lines. Error: %lu\n", sequence, GetLastError());
+            return 1;
+        }
+    }
+
+    free(frame);
+    free(line);
+    return 0;
+}
@@ -0,0 +1,379 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "Config.h"
+#include "ConsoleWriter.h"
+#include "PipeReader.h"
+#include "Ipc.h"
+
+// Measures the launcher's output path. Starts bench_child.exe on an overlapped named pipe and
+// relays its output through the same PipeReader, IpcDecoder and ConsoleWriter code (and the
+// same wait/flush policy) as processPipeDataLoop, then reports throughput, the p50/p99 latency
+// from a line being written by the child to it being flushed to the console, and the CPU used
+// by the driver.
+//
+//   bench_driver.exe [--lines N] [--size BYTES] [--rate LINES_PER_SECOND] [--framed]
+//                    [--read-buffer BYTES] [--pipe-buffer BYTES] [--ring BYTES]
+//                    [--flush-bytes BYTES] [--flush-ms MS] [--null] [--child PATH]
+//
+// Buffer sizes default to the launcher's own defaults. --null writes the relayed output to
+// NUL instead of the console, which isolates the pipe and batching cost from the console's.
+
+// Arguments to bench_child.exe and the run being measured
+typedef struct
+{
+    DWORD lines;
+    DWORD size;
+    DWORD rate;
+    BOOL framed;
+    BOOL nullOutput;
+    DWORD readBufferSize;
+    DWORD pipeBufferSize;
+    DWORD ringSize;
+    DWORD flushBytes;
+    DWORD flushIntervalMs;
+    char childPath[MAX_PATH];
+} BenchOptions;
+
+// Finds the timestamp at the start of every relayed line and remembers where the line ends
+// in the writer's output stream, so its latency can be taken once the writer flushes past it.
+typedef struct
+{
+    ConsoleWriter *writer;
+    char stamp[17];             // Hex timestamp of the current line
+    DWORD stampLength;          // Digits collected so far, 16 once complete
+    LONGLONG *sentQpc;          // QPC written by the child, per line
+    ULONGLONG *endPos;          // writer->writePos just after the line's newline, per line
+    LONGLONG *latency;          // QPC ticks from write to flush, per line
+    DWORD capacity;             // Lines the arrays can hold
+    DWORD count;                // Lines seen
+    DWORD flushedCount;         // Lines whose latency has been taken
+} LatencyTracker;
+
+BOOL parseArguments(BenchOptions *options, int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *argument = argv[i];
+        BOOL hasValue = i + 1 < argc;
+
+        if (strcmp(argument, "--framed") == 0)
+            options->framed = TRUE;
+        else if (strcmp(argument, "--null") == 0)
+            options->nullOutput = TRUE;
+        else if (strcmp(argument, "--child") == 0 && hasValue)
+            snprintf(options->childPath, sizeof(options->childPath), "%s", argv[++i]);
+        else if (strcmp(argument, "--lines") == 0 && hasValue)
+            options->lines = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argument, "--size") == 0 && hasValue)
+            options->size = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argument, "--rate") == 0 && hasValue)
+            options->rate = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argument, "--read-buffer") == 0 && hasValue)
+            options->readBufferSize = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argument, "--pipe-buffer") == 0 && hasValue)
+            options->pipeBufferSize = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argument, "--ring") == 0 && hasValue)
+            options->ringSize = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argument, "--flush-bytes") == 0 && hasValue)
+            options->flushBytes = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argument, "--flush-ms") == 0 && hasValue)
+            options->flushIntervalMs = strtoul(argv[++i], NULL, 10);
+        else
+        {
+            printf("[ERROR] Unknown or incomplete argument: %s\n", argument);
+            return FALSE;
+        }
+    }
+
+    if (!options->lines || !options->readBufferSize || !options->ringSize)
+    {
+        printf("[ERROR] --lines, --read-buffer and --ring must be greater than zero.\n");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Scan relayed bytes for line timestamps. Called before the bytes are appended to the writer.
+void trackLines(LatencyTracker *tracker, const char *data, DWORD length)
+{
+    for (DWORD i = 0; i < length; i++)
+    {
+        char c = data[i];
+        if (c == '\n')
+        {
+            if (tracker->stampLength == 16 && tracker->count < tracker->capacity)
+            {
+                tracker->stamp[16] = '\0';
+                tracker->sentQpc[tracker->count] = (LONGLONG)_strtoui64(tracker->stamp, NULL, 16);
+                tracker->endPos[tracker->count] = tracker->writer->writePos + i + 1;
+                tracker->count++;
+            }
+            tracker->stampLength = 0;
+        }
+        else if (tracker->stampLength < 16)
+        {
+            tracker->stamp[tracker->stampLength++] = c;
+        }
+    }
+}
+
+// Take the latency of every line the writer has flushed since the last call.
+void collectFlushedLines(LatencyTracker *tracker)
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    while (tracker->flushedCount < tracker->count &&
+           tracker->endPos[tracker->flushedCount] <= tracker->writer->flushedPos)
+    {
+        tracker->latency[tracker->flushedCount] = now.QuadPart - tracker->sentQpc[tracker->flushedCount];
+        tracker->flushedCount++;
+    }
+}
+
+// Track and append relayed text, the driver's equivalent of sinkAppend.
+void benchAppend(LatencyTracker *tracker, const char *data, DWORD length)
+{
+    trackLines(tracker, data, length);
+    consoleWriterAppend(tracker->writer, data, length);
+}
+
+// Frame handler: only the LOG channel is produced by bench_child.exe
+void benchFrame(void *context, BYTE channel, const char *payload, DWORD length)
+{
+    if (channel == IPC_CHANNEL_LOG)
+        benchAppend((LatencyTracker *)context, payload, length);
+}
+
+// Same as relayPipeData in Launcher.c: relay the read, queue the next one, and flush once the
+// pipe is drained or the batch is due.
+void benchRelay(PipeReader *reader, LatencyTracker *tracker, IpcDecoder *decoder)
+{
+    DWORD bytesRead = completePipeRead(reader);
+    if (decoder)
+        ipcDecoderFeed(decoder, reader->buffer, bytesRead, benchFrame, tracker);
+    else
+        benchAppend(tracker, reader->buffer, bytesRead);
+    beginPipeRead(reader);
+
+    if (!reader->pending || WaitForSingleObject(reader->overlapped.hEvent, 0) != WAIT_OBJECT_0)
+        consoleWriterFlush(tracker->writer);
+    else
+        consoleWriterFlushIfDue(tracker->writer);
+}
+
+int compareLatency(const void *a, const void *b)
+{
+    LONGLONG left = *(const LONGLONG *)a;
+    LONGLONG right = *(const LONGLONG *)b;
+    return left < right ? -1 : left > right;
+}
+
+// Latency at the given percentile in microseconds. The samples must be sorted.
+double latencyPercentile(const LONGLONG *sorted, DWORD count, DWORD percentile, LONGLONG frequency)
+{
+    if (!count)
+        return 0.0;
+    DWORD index = (DWORD)(((ULONGLONG)count * percentile + 99) / 100);
+    index = index ? index - 1 : 0;
+    return (double)sorted[index] * 1000000.0 / (double)frequency;
+}
+
+ULONGLONG fileTimeToUlong(FILETIME time)
+{
+    return ((ULONGLONG)time.dwHighDateTime << 32) | time.dwLowDateTime;
+}
+
+// CPU time (user + kernel) used by this process so far, in 100 ns units
+ULONGLONG processCpuTime(void)
+{
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0;
+    return fileTimeToUlong(kernelTime) + fileTimeToUlong(userTime);
+}
+
+// Start bench_child.exe with its stdout on the client end of the pipe.
+BOOL startChild(const BenchOptions *options, const char *pipeName, PROCESS_INFORMATION *pi)
+{
+    SECURITY_ATTRIBUTES sa = {sizeof(SECURITY_ATTRIBUTES), NULL, TRUE};
+    HANDLE client = CreateFile(pipeName, GENERIC_WRITE, 0, &sa, OPEN_EXISTING, 0, NULL);
+    if (client == INVALID_HANDLE_VALUE)
+    {
+        printf("[ERROR] Failed to open the client end of the pipe. Error: %lu\n", GetLastError());
+        return FALSE;
+    }
+
+    char commandLine[MAX_PATH + 128];
+    snprintf(commandLine, sizeof(commandLine), "\"%s\" --lines %lu --size %lu --rate %lu%s",
+             options->childPath, options->lines, options->size, options->rate,
+             options->framed ? " --framed" : "");
+
+    STARTUPINFO si = {sizeof(STARTUPINFO)};
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    si.hStdOutput = client;
+    si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    BOOL started = CreateProcess(NULL, commandLine, NULL, NULL, TRUE, 0, NULL, NULL, &si, pi);
+    if (!started)
+        printf("[ERROR] Failed to start %s. Error: %lu\n", options->childPath, GetLastError());
+
+    // The child holds its own copy; closing ours lets the pipe break when the child exits
+    CloseHandle(client);
+    return started;
+}
+
+// Print the results of a run
+void printReport(const BenchOptions *options, LatencyTracker *tracker, ULONGLONG bytes,
+                 LONGLONG elapsedQpc, LONGLONG frequency, ULONGLONG cpuTime)
+{
+    double seconds = (double)elapsedQpc / (double)frequency;
+    if (seconds <= 0.0)
+        seconds = 1e-9;
+
+    qsort(tracker->latency, tracker->flushedCount, sizeof(LONGLONG), compareLatency);
+
+    fprintf(stderr, "\n[INFO] Pipe benchmark: %lu lines of %lu bytes, rate %s%lu, %s, output %s\n",
+            options->lines, options->size, options->rate ? "" : "unlimited ", options->rate,
+            options->framed ? "framed" : "unframed", options->nullOutput ? "NUL" : "console");
+    fprintf(stderr, "[INFO] Buffers: read %lu, pipe %lu, ring %lu, flush %lu bytes / %lu ms\n",
+            options->readBufferSize, options->pipeBufferSize, options->ringSize,
+            options->flushBytes, options->flushIntervalMs);
+    fprintf(stderr, "[INFO] Lines received:  %lu of %lu\n", tracker->flushedCount, options->lines);
+    fprintf(stderr, "[INFO] Elapsed:         %.3f s\n", seconds);
+    fprintf(stderr, "[INFO] Throughput:      %.2f MB/s, %.0f lines/s\n",
+            (double)bytes / (1024.0 * 1024.0) / seconds, (double)tracker->flushedCount / seconds);
+    fprintf(stderr, "[INFO] Latency:         p50 %.1f us, p99 %.1f us, max %.1f us\n",
+            latencyPercentile(tracker->latency, tracker->flushedCount, 50, frequency),
+            latencyPercentile(tracker->latency, tracker->flushedCount, 99, frequency),
+            latencyPercentile(tracker->latency, tracker->flushedCount, 100, frequency));
+    fprintf(stderr, "[INFO] Launcher CPU:    %.1f%% of one core\n",
+            (double)cpuTime / 1e7 / seconds * 100.0);
+}
+
+int main(int argc, char *argv[])
+{
+    LauncherConfig config;
+    BenchOptions options = {0};
+
+    // Measure with the launcher's own defaults unless overridden
+    initDefaultConfig(&config);
+    options.lines = 100000;
+    options.size = 100;
+    options.readBufferSize = config.readBufferSize;
+    options.pipeBufferSize = config.outputPipeBufferSize;
+    options.ringSize = config.outputRingSize;
+    options.flushBytes = config.outputFlushBytes;
+    options.flushIntervalMs = config.outputFlushIntervalMs;
+    GetModuleFileName(NULL, options.childPath, sizeof(options.childPath));
+    char *slash = strrchr(options.childPath, '\\');
+    snprintf(slash ? slash + 1 : options.childPath,
+             sizeof(options.childPath) - (slash ? (DWORD)(slash + 1 - options.childPath) : 0),
+             "bench_child.exe");
+
+    if (!parseArguments(&options, argc, argv))
+        return 1;
+
+    // The report goes to stderr so it stays readable when stdout is the relayed flood
+    if (options.nullOutput)
+    {
+        HANDLE nul = CreateFile("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+        if (nul != INVALID_HANDLE_VALUE)
+            SetStdHandle(STD_OUTPUT_HANDLE, nul);
+    }
+
+    char pipeName[128];
+    snprintf(pipeName, sizeof(pipeName), "\\\\.\\pipe\\MSFSPyScriptManagerBench_%lu", GetCurrentProcessId());
+    HANDLE pipe = CreateNamedPipe(pipeName, PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED,
+                                  PIPE_TYPE_BYTE | PIPE_WAIT, 1, options.pipeBufferSize,
+                                  options.pipeBufferSize, 0, NULL);
+    if (pipe == INVALID_HANDLE_VALUE)
+    {
+        printf("[ERROR] Failed to create the benchmark pipe. Error: %lu\n", GetLastError());
+        return 1;
+    }
+
+    ConsoleWriter writer;
+    PipeReader reader;
+    IpcDecoder decoderState;
+    IpcDecoder *decoder = NULL;
+    LatencyTracker tracker = {0};
+    tracker.writer = &writer;
+    tracker.capacity = options.lines;
+    tracker.sentQpc = (LONGLONG *)malloc(sizeof(LONGLONG) * options.lines);
+    tracker.endPos = (ULONGLONG *)malloc(sizeof(ULONGLONG) * options.lines);
+    tracker.latency = (LONGLONG *)malloc(sizeof(LONGLONG) * options.lines);
+
+    if (!tracker.sentQpc || !tracker.endPos || !tracker.latency ||
+        !initConsoleWriter(&writer, options.ringSize, options.flushBytes, options.flushIntervalMs) ||
+        !initPipeReader(&reader, pipe, options.readBufferSize))
+    {
+        printf("[ERROR] Failed to allocate benchmark buffers.\n");
+        return 1;
+    }
+    if (options.framed && initIpcDecoder(&decoderState))
+        decoder = &decoderState;
+
+    // The driver opens the client end itself, so the pipe is connected before the child starts
+    PROCESS_INFORMATION pi;
+    if (!startChild(&options, pipeName, &pi))
+        return 1;
+
+    LARGE_INTEGER frequency, start, end;
+    QueryPerformanceFrequency(&frequency);
+    ULONGLONG cpuStart = processCpuTime();
+    QueryPerformanceCounter(&start);
+
+    // processPipeDataLoop without the heartbeat, telemetry and pool handles
+    beginPipeRead(&reader);
+    while (!reader.closed)
+    {
+        HANDLE waitHandles[] = {reader.overlapped.hEvent, pi.hProcess};
+        DWORD waitResult = WaitForMultipleObjects(2, waitHandles, FALSE, consoleWriterTimeout(&writer));
+
+        if (waitResult == WAIT_TIMEOUT)
+            consoleWriterFlush(&writer);
+        else if (waitResult == WAIT_OBJECT_0)
+            benchRelay(&reader, &tracker, decoder);
+        else if (waitResult == WAIT_OBJECT_0 + 1)
+        {
+            // Child exited: relay what is left in the pipe, then stop
+            while (reader.pending && WaitForSingleObject(reader.overlapped.hEvent, INFINITE) == WAIT_OBJECT_0)
+                benchRelay(&reader, &tracker, decoder);
+            break;
+        }
+        else
+        {
+            printf("[ERROR] Wait failed in benchmark loop. Error: %lu\n", GetLastError());
+            break;
+        }
+        collectFlushedLines(&tracker);
+    }
+    consoleWriterFlush(&writer);
+    collectFlushedLines(&tracker);
+
+    QueryPerformanceCounter(&end);
+    ULONGLONG cpuTime = processCpuTime() - cpuStart;
+
+    printReport(&options, &tracker, writer.writePos, end.QuadPart - start.QuadPart, frequency.QuadPart, cpuTime);
+
+    DWORD exitCode = 0;
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    GetExitCodeProcess(pi.hProcess, &exitCode);
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+
+    closePipeReader(&reader);
+    if (decoder)
+        closeIpcDecoder(decoder);
+    closeConsoleWriter(&writer);
+    CloseHandle(pipe);
+    free(tracker.sentQpc);
+    free(tracker.endPos);
+    free(tracker.latency);
+    return exitCode ? 1 : 0;
+}
@@ -18,8 +18,11 @@ if not exist "%tcc_path%" (
 REM Change directory to the Source folder where main.c is located
 cd Source
 
+REM Source files that make up the launcher
+call "%~dp0Sources.bat"
+
 REM Compile the C program using TinyCC
-"%tcc_path%" launcher.c -o ..\..\..\MSFS-PyScriptManager.exe 2>&1 | findstr /i "error"
+"%tcc_path%" %sources% -o ..\..\..\MSFS-PyScriptManager.exe 2>&1 | findstr /i "error"
 if %errorlevel% equ 0 (
     set "status=failed"
     goto :cleanup
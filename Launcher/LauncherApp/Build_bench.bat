@@ -0,0 +1,46 @@
+@echo off
+REM Builds the pipe benchmark with TinyCC: bench_child.exe writes timestamped lines and
+REM bench_driver.exe relays them through the launcher's pipe and console code.
+REM
+REM   Bench\bench_driver.exe --lines 200000 --size 120 [--rate 5000] [--framed] [--null]
+REM
+REM See the comment at the top of Bench\BenchDriver.c for every option.
+
+REM Save the current directory
+set "original_dir=%CD%"
+set "status="
+
+REM Construct the full path to the TinyCC executable relative to the batch file
+set "tcc_path=%~dp0tcc\tcc.exe"
+
+REM Verify if tcc.exe exists
+if not exist "%tcc_path%" (
+    echo Error: Could not find tcc.exe at "%tcc_path%".
+    pause
+    exit /b 1
+)
+
+cd "%~dp0Bench"
+
+REM The driver links the launcher modules it measures
+"%tcc_path%" -I..\Source BenchChild.c ..\Source\Ipc.c -o bench_child.exe 2>&1 | findstr /i "error"
+if %errorlevel% equ 0 goto :failed
+"%tcc_path%" -I..\Source BenchDriver.c ..\Source\Config.c ..\Source\ConsoleWriter.c ..\Source\PipeReader.c ..\Source\Ipc.c -o bench_driver.exe 2>&1 | findstr /i "error"
+if %errorlevel% equ 0 goto :failed
+
+set "status=success"
+goto :cleanup
+
+:failed
+set "status=failed"
+
+:cleanup
+REM Navigate back to the original directory
+cd "%original_dir%"
+
+if "%status%"=="failed" (
+    echo Compilation failed. See the error above.
+    pause
+    exit /b 1
+)
+echo Compilation complete. The benchmark has been created in the Bench folder.
@@ -0,0 +1,82 @@
+@echo off
+REM Optimized build of the launcher with MSVC (cl) or clang-cl.
+REM Run from a Developer Command Prompt so the compiler and Windows SDK are on the path.
+REM
+REM   Build_msvc.bat [release | instrument | optimize]
+REM
+REM   release     /O2, whole program optimization (LTO) and the static CRT (default)
+REM   instrument  As release, with PGO instrumentation. Run the exe through typical sessions,
+REM               then build again with "optimize".
+REM   optimize    As release, using the profile collected by the instrumented exe.
+REM
+REM Set CC=clang-cl to build with clang-cl instead of cl. The exe is written next to the
+REM TinyCC build as MSFS-PyScriptManager-msvc.exe so the two can be compared side by side.
+
+REM Save the current directory
+set "original_dir=%CD%"
+set "status="
+
+set "mode=%~1"
+if "%mode%"=="" set "mode=release"
+if "%CC%"=="" set "CC=cl"
+if /i not "%mode%"=="release" if /i not "%mode%"=="instrument" if /i not "%mode%"=="optimize" (
+    echo Error: unknown build mode "%mode%". Use release, instrument or optimize.
+    exit /b 1
+)
+
+REM Verify the compiler is available
+where %CC% >nul 2>&1
+if errorlevel 1 (
+    echo Error: %CC% was not found. Run this from a Visual Studio Developer Command Prompt.
+    pause
+    exit /b 1
+)
+
+cd "%~dp0Source"
+call "%~dp0Sources.bat"
+
+set "output=..\..\..\MSFS-PyScriptManager-msvc.exe"
+set "objdir=..\build_msvc"
+set "profile=%objdir%\launcher.profdata"
+if not exist "%objdir%" mkdir "%objdir%"
+
+REM Common flags: optimize for speed, static CRT
+set "cflags=/nologo /O2 /MT /W3 /DNDEBUG /D_CRT_SECURE_NO_WARNINGS /Fo%objdir%\"
+set "ldflags=/link /OPT:REF /OPT:ICF kernel32.lib"
+
+REM Link time optimization and PGO (one statement per line so each sees the previous value)
+if /i "%CC%"=="clang-cl" goto :clang_flags
+set "cflags=%cflags% /GL"
+set "ldflags=%ldflags% /LTCG"
+if /i "%mode%"=="instrument" set "ldflags=%ldflags% /GENPROFILE:PGD=%objdir%\launcher.pgd"
+if /i "%mode%"=="optimize" set "ldflags=%ldflags% /USEPROFILE:PGD=%objdir%\launcher.pgd"
+goto :build
+
+:clang_flags
+set "cflags=%cflags% -flto -fuse-ld=lld"
+if /i "%mode%"=="instrument" set "cflags=%cflags% -fprofile-instr-generate"
+if /i "%mode%"=="optimize" set "cflags=%cflags% -fprofile-instr-use=%profile%"
+
+:build
+echo Building %mode% launcher with %CC%...
+%CC% %cflags% %sources% /Fe%output% %ldflags%
+if errorlevel 1 (
+    set "status=failed"
+    goto :cleanup
+)
+set "status=success"
+
+:cleanup
+cd "%original_dir%"
+
+if "%status%"=="failed" (
+    echo Compilation failed. See the errors above.
+    pause
+    exit /b 1
+)
+
+echo Compilation complete. MSFS-PyScriptManager-msvc.exe has been created in the main directory.
+if /i "%mode%"=="instrument" (
+    echo Run it through a few typical sessions, then run "Build_msvc.bat optimize".
+    if /i "%CC%"=="clang-cl" echo Merge the .profraw files into %profile% with llvm-profdata first.
+)
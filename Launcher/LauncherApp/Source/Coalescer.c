@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <string.h>
+#include "Coalescer.h"
+
+// Set up a coalescer passing its output to emit.
+void initCoalescer(Coalescer *coalescer, DWORD windowMs, CoalesceEmitFn emit, void *context)
+{
+    ZeroMemory(coalescer, sizeof(*coalescer));
+    coalescer->windowMs = windowMs;
+    coalescer->emit = emit;
+    coalescer->context = context;
+    coalescer->atLineStart = TRUE;
+}
+
+// Emit the summary of counted copies, if any.
+static void emitSummary(Coalescer *coalescer)
+{
+    char summary[COALESCE_LINE_MAX + 64];
+
+    if (!coalescer->repeats)
+        return;
+
+    // The line without its line ending, followed by the count and time range
+    DWORD lineLength = coalescer->lastLength - 1;
+    if (lineLength && coalescer->lastLine[lineLength - 1] == '\r')
+        lineLength--;
+    memcpy(summary, coalescer->lastLine, lineLength);
+
+    const SYSTEMTIME *first = &coalescer->firstRepeat;
+    const SYSTEMTIME *last = &coalescer->lastRepeat;
+    int length = snprintf(summary + lineLength, sizeof(summary) - lineLength,
+                          " [repeated %lu times, %02u:%02u:%02u.%03u - %02u:%02u:%02u.%03u]\n",
+                          coalescer->repeats, first->wHour, first->wMinute, first->wSecond, first->wMilliseconds,
+                          last->wHour, last->wMinute, last->wSecond, last->wMilliseconds);
+    coalescer->repeats = 0;
+    if (length > 0)
+        coalescer->emit(coalescer->context, summary, lineLength + (DWORD)length);
+}
+
+// Count one more copy of the last line.
+static void countCopy(Coalescer *coalescer)
+{
+    if (!coalescer->repeats)
+    {
+        coalescer->windowStart = GetTickCount();
+        GetLocalTime(&coalescer->firstRepeat);
+    }
+    GetLocalTime(&coalescer->lastRepeat);
+    coalescer->repeats++;
+}
+
+// Emit the summary of counted copies and the held back line start, if any.
+void coalescerFlush(Coalescer *coalescer)
+{
+    emitSummary(coalescer);
+    if (coalescer->heldLength)
+    {
+        // The start goes out as it is; the rest of its line passes through when it comes
+        coalescer->emit(coalescer->context, coalescer->lastLine, coalescer->heldLength);
+        coalescer->heldLength = 0;
+        coalescer->lastLength = 0;
+        coalescer->atLineStart = FALSE;
+    }
+}
+
+// Pass output through, counting copies of the last line instead of emitting them. Runs of
+// lines that pass through are emitted with one call; a trailing partial line that matches the
+// start of the last line is held back until the next feed.
+void coalescerFeed(Coalescer *coalescer, const char *data, DWORD length)
+{
+    const char *passStart = data;
+
+    while (length > 0)
+    {
+        const char *newline = (const char *)memchr(data, '\n', length);
+        DWORD segment = newline ? (DWORD)(newline - data) + 1 : length;
+
+        if (coalescer->heldLength)
+        {
+            // The rest of a line whose start was held back; it is the first segment of a feed
+            DWORD lineLength = coalescer->heldLength + segment;
+            if (lineLength <= coalescer->lastLength &&
+                memcmp(coalescer->lastLine + coalescer->heldLength, data, segment) == 0)
+            {
+                // Still a copy so far; counted once its line ending is in
+                passStart = data + segment;
+                if (newline)
+                {
+                    coalescer->heldLength = 0;
+                    countCopy(coalescer);
+                }
+                else
+                {
+                    coalescer->heldLength = lineLength;
+                }
+            }
+            else
+            {
+                // A different line after all: the run's summary, then the held start
+                emitSummary(coalescer);
+                coalescer->emit(coalescer->context, coalescer->lastLine, coalescer->heldLength);
+                coalescer->heldLength = 0;
+
+                // lastLine already starts with the held part
+                if (newline && lineLength <= COALESCE_LINE_MAX)
+                {
+                    memcpy(coalescer->lastLine + lineLength - segment, data, segment);
+                    coalescer->lastLength = lineLength;
+                }
+                else
+                {
+                    coalescer->lastLength = 0;
+                }
+                coalescer->atLineStart = newline != NULL;
+            }
+        }
+        else if (newline && coalescer->atLineStart && coalescer->lastLength == segment &&
+                 memcmp(coalescer->lastLine, data, segment) == 0)
+        {
+            // A copy of the last line: emit what passed before it and count it
+            if (data > passStart)
+                coalescer->emit(coalescer->context, passStart, (DWORD)(data - passStart));
+            passStart = data + segment;
+            countCopy(coalescer);
+        }
+        else if (!newline && coalescer->atLineStart && segment < coalescer->lastLength &&
+                 memcmp(coalescer->lastLine, data, segment) == 0)
+        {
+            // The start of what may be another copy, cut off by the end of the read: keep it
+            // out of the output until the rest of the line shows whether it is one
+            if (data > passStart)
+                coalescer->emit(coalescer->context, passStart, (DWORD)(data - passStart));
+            passStart = data + segment;
+            coalescer->heldLength = segment;
+            coalescer->heldStart = GetTickCount();
+        }
+        else
+        {
+            // A different line ends the run; its summary goes out before the line
+            emitSummary(coalescer);
+
+            if (newline && coalescer->atLineStart && segment <= COALESCE_LINE_MAX)
+            {
+                memcpy(coalescer->lastLine, data, segment);
+                coalescer->lastLength = segment;
+            }
+            else
+            {
+                coalescer->lastLength = 0; // Partial or too long, nothing to compare with
+            }
+            coalescer->atLineStart = newline != NULL;
+        }
+
+        data += segment;
+        length -= segment;
+    }
+
+    if (data > passStart)
+        coalescer->emit(coalescer->context, passStart, (DWORD)(data - passStart));
+}
+
+// Emit the summary if the run has been held back for windowMs, and the held line start if it
+// has waited that long (a prompt, say, that never gets its line ending).
+void coalescerFlushIfDue(Coalescer *coalescer)
+{
+    DWORD now = GetTickCount();
+    if (coalescer->heldLength && now - coalescer->heldStart >= coalescer->windowMs)
+        coalescerFlush(coalescer);
+    else if (coalescer->repeats && now - coalescer->windowStart >= coalescer->windowMs)
+        emitSummary(coalescer); // The line stays, so the run goes on in the next window
+}
+
+// Milliseconds until a summary or the held line start is due.
+DWORD coalescerTimeout(const Coalescer *coalescer)
+{
+    DWORD timeout = INFINITE;
+    DWORD now = GetTickCount();
+
+    if (coalescer->repeats)
+    {
+        DWORD elapsed = now - coalescer->windowStart;
+        timeout = elapsed >= coalescer->windowMs ? 0 : coalescer->windowMs - elapsed;
+    }
+    if (coalescer->heldLength)
+    {
+        DWORD elapsed = now - coalescer->heldStart;
+        DWORD heldTimeout = elapsed >= coalescer->windowMs ? 0 : coalescer->windowMs - elapsed;
+        if (heldTimeout < timeout)
+            timeout = heldTimeout;
+    }
+    return timeout;
+}
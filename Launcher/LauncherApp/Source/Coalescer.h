@@ -0,0 +1,52 @@
+#ifndef COALESCER_H
+#define COALESCER_H
+
+#include <windows.h>
+
+// Longest line compared against the one before it; longer lines always pass through
+#define COALESCE_LINE_MAX 1024
+
+// Receives the output of a coalescer
+typedef void (*CoalesceEmitFn)(void *context, const char *data, DWORD length);
+
+// Collapses identical consecutive lines of one output stream. The first copy of a line passes
+// through at once; the copies after it are only counted and then reported as one summary line
+//   <line> [repeated N times, 12:00:01.250 - 12:00:02.250]
+// when a different line arrives, when the stream ends, or at least every windowMs while the
+// run goes on. A script printing the same status line hundreds of times a second costs the UI
+// one line per window. A line split between reads is still compared: while its start matches
+// the last line it is held back, for at most windowMs, until it is complete or differs.
+typedef struct
+{
+    DWORD windowMs;             // Longest time repeats are held back before a summary
+    CoalesceEmitFn emit;
+    void *context;
+    char lastLine[COALESCE_LINE_MAX]; // Last complete line passed through, newline included
+    DWORD lastLength;           // 0 when there is no line to compare with
+    BOOL atLineStart;           // FALSE while a line is only partly through
+    DWORD heldLength;           // Start of the next line held back, a prefix of lastLine
+    DWORD heldStart;            // Tick count the held start arrived at
+    DWORD repeats;              // Copies counted since the last summary
+    DWORD windowStart;          // Tick count of the first counted copy
+    SYSTEMTIME firstRepeat;     // Local time of the first and last counted copies
+    SYSTEMTIME lastRepeat;
+} Coalescer;
+
+// Set up a coalescer passing its output to emit.
+void initCoalescer(Coalescer *coalescer, DWORD windowMs, CoalesceEmitFn emit, void *context);
+
+// Pass output through, counting copies of the last line instead of emitting them.
+void coalescerFeed(Coalescer *coalescer, const char *data, DWORD length);
+
+// Emit the summary of counted copies and the held back line start, if any. Call when the
+// stream ends.
+void coalescerFlush(Coalescer *coalescer);
+
+// Emit the summary if the run has been held back for windowMs, and the held back line start
+// if it has waited that long.
+void coalescerFlushIfDue(Coalescer *coalescer);
+
+// Milliseconds until a summary or the held line start is due, INFINITE if nothing is held back.
+DWORD coalescerTimeout(const Coalescer *coalescer);
+
+#endif // COALESCER_H
@@ -0,0 +1,110 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CommandLine.h"
+
+// First allocation, enough for a typical Launcher.py command line
+#define COMMAND_LINE_INITIAL_CAPACITY 512
+
+void initCommandLine(CommandLine *commandLine)
+{
+    ZeroMemory(commandLine, sizeof(*commandLine));
+}
+
+// Make room for length more characters and the terminator.
+static BOOL reserveCommandLine(CommandLine *commandLine, size_t length)
+{
+    if (commandLine->failed)
+        return FALSE;
+
+    size_t needed = commandLine->length + length + 1;
+    if (needed <= commandLine->capacity)
+        return TRUE;
+
+    size_t capacity = commandLine->capacity ? commandLine->capacity : COMMAND_LINE_INITIAL_CAPACITY;
+    while (capacity < needed)
+        capacity *= 2;
+
+    char *text = (char *)realloc(commandLine->text, capacity);
+    if (!text)
+    {
+        commandLine->failed = TRUE;
+        return FALSE;
+    }
+    commandLine->text = text;
+    commandLine->capacity = capacity;
+    return TRUE;
+}
+
+void appendCommandLine(CommandLine *commandLine, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (length < 0)
+    {
+        commandLine->failed = TRUE;
+        return;
+    }
+    if (!reserveCommandLine(commandLine, (size_t)length))
+        return;
+
+    va_start(args, format);
+    vsnprintf(commandLine->text + commandLine->length, (size_t)length + 1, format, args);
+    va_end(args);
+    commandLine->length += (size_t)length;
+}
+
+// Append one character; room has been reserved.
+static void putCommandLineChar(CommandLine *commandLine, char c)
+{
+    commandLine->text[commandLine->length++] = c;
+}
+
+void appendCommandLineArgument(CommandLine *commandLine, const char *argument)
+{
+    // Worst case every character is a backslash or quote that needs escaping
+    size_t argumentLength = strlen(argument);
+    if (!reserveCommandLine(commandLine, argumentLength * 2 + 3))
+        return;
+
+    if (commandLine->length)
+        putCommandLineChar(commandLine, ' ');
+    putCommandLineChar(commandLine, '"');
+    size_t backslashes = 0;
+    for (const char *c = argument; *c; c++)
+    {
+        if (*c == '\\')
+        {
+            backslashes++;
+            continue;
+        }
+
+        // Backslashes are only special in front of a quote
+        size_t repeat = *c == '"' ? backslashes * 2 + 1 : backslashes;
+        for (size_t i = 0; i < repeat; i++)
+            putCommandLineChar(commandLine, '\\');
+        backslashes = 0;
+        putCommandLineChar(commandLine, *c);
+    }
+
+    // Trailing backslashes are doubled so the closing quote stays a quote
+    for (size_t i = 0; i < backslashes * 2; i++)
+        putCommandLineChar(commandLine, '\\');
+    putCommandLineChar(commandLine, '"');
+    commandLine->text[commandLine->length] = '\0';
+}
+
+BOOL commandLineReady(const CommandLine *commandLine)
+{
+    return !commandLine->failed && commandLine->text;
+}
+
+void freeCommandLine(CommandLine *commandLine)
+{
+    free(commandLine->text);
+    ZeroMemory(commandLine, sizeof(*commandLine));
+}
@@ -0,0 +1,31 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <windows.h>
+
+// Command line built on the heap, so long install paths and extra interpreter options are
+// never cut off. A failed allocation marks the line failed and later appends do nothing, so
+// callers check once before using it.
+typedef struct
+{
+    char *text;         // NUL terminated, NULL until the first append
+    size_t length;
+    size_t capacity;
+    BOOL failed;
+} CommandLine;
+
+void initCommandLine(CommandLine *commandLine);
+
+// Append printf-style text as it is.
+void appendCommandLine(CommandLine *commandLine, const char *format, ...);
+
+// Append one argument, after a space unless it is the first, quoted so CommandLineToArgvW
+// gives it back unchanged.
+void appendCommandLineArgument(CommandLine *commandLine, const char *argument);
+
+// TRUE when every append succeeded.
+BOOL commandLineReady(const CommandLine *commandLine);
+
+void freeCommandLine(CommandLine *commandLine);
+
+#endif // COMMAND_LINE_H
@@ -0,0 +1,431 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Config.h"
+
+// Kinds of values a setting can hold
+typedef enum
+{
+    CONFIG_DWORD,
+    CONFIG_QWORD,  // ULONGLONG, for masks wider than 32 bits
+    CONFIG_BOOL,
+    CONFIG_STRING  // char[CONFIG_STRING_SIZE]
+} ConfigType;
+
+// Describes one setting: where it lives in the settings file and on the command line
+typedef struct
+{
+    const char *section;     // Settings file section
+    const char *key;         // Settings file key
+    const char *option;      // Command line option (without the leading "--")
+    ConfigType type;         // Value type
+    size_t offset;           // Offset of the field in LauncherConfig
+    const char *description; // Help text
+} ConfigOption;
+
+static const ConfigOption g_configOptions[] = {
+    {"Python", "Interpreter", "python", CONFIG_STRING, offsetof(LauncherConfig, pythonPath),
+     "Python interpreter for Launcher.py, pool workers and headless scripts"},
+    {"Python", "Script", "script", CONFIG_STRING, offsetof(LauncherConfig, scriptPath),
+     "UI script started by the launcher"},
+    {"Python", "Flags", "python-flags", CONFIG_STRING, offsetof(LauncherConfig, pythonFlags),
+     "Extra interpreter options for Launcher.py, e.g. \"-X frozen_modules=on -X importtime\""},
+    {"Python", "Optimize", "python-optimize", CONFIG_DWORD, offsetof(LauncherConfig, pythonOptimize),
+     "PYTHONOPTIMIZE level for every Python process (1 strips asserts, 2 also docstrings, 0 leaves it alone)"},
+    {"Python", "Environment", "python-env", CONFIG_STRING, offsetof(LauncherConfig, environment),
+     "Environment variables for every Python process, NAME=VALUE pairs separated by ';'"},
+    {"Output", "ReadBufferSize",  "read-buffer-size",  CONFIG_DWORD, offsetof(LauncherConfig, readBufferSize),
+     "Bytes requested per read from the output pipe"},
+    {"Output", "RingSize",        "output-ring-size",  CONFIG_DWORD, offsetof(LauncherConfig, outputRingSize),
+     "Console output ring buffer size in bytes"},
+    {"Output", "FlushBytes",      "flush-bytes",       CONFIG_DWORD, offsetof(LauncherConfig, outputFlushBytes),
+     "Flush console output once this many bytes are pending"},
+    {"Output", "FlushIntervalMs", "flush-interval-ms", CONFIG_DWORD, offsetof(LauncherConfig, outputFlushIntervalMs),
+     "Longest time output is held before it is flushed"},
+    {"Output", "CoalesceWindowMs", "coalesce-window-ms", CONFIG_DWORD, offsetof(LauncherConfig, coalesceWindowMs),
+     "Collapse repeated lines of a script into one summary line at least this often (ms), 0 disables"},
+    {"Output", "NativeAnsi", "native-ansi", CONFIG_BOOL, offsetof(LauncherConfig, nativeAnsi),
+     "Parse script color codes in the launcher and send text with style runs (0 or 1, needs SpawnService)"},
+    {"Pipes",  "OutputBufferSize",  "output-pipe-buffer",  CONFIG_DWORD, offsetof(LauncherConfig, outputPipeBufferSize),
+     "Kernel buffer size of the script output pipe"},
+    {"Pipes",  "CommandBufferSize", "command-pipe-buffer", CONFIG_DWORD, offsetof(LauncherConfig, commandPipeBufferSize),
+     "Kernel buffer size of the command pipe"},
+    {"Pipes",  "CommandMessageMode", "command-message-mode", CONFIG_BOOL, offsetof(LauncherConfig, commandMessageMode),
+     "Send commands as whole pipe messages (0 or 1)"},
+    {"Pipes",  "Framing", "framed-ipc", CONFIG_BOOL, offsetof(LauncherConfig, ipcFraming),
+     "Multiplex channels over the pipes with length-prefixed frames (0 or 1)"},
+    {"Pipes",  "ConnectTimeoutMs", "connect-timeout-ms", CONFIG_DWORD, offsetof(LauncherConfig, connectTimeoutMs),
+     "Longest wait for Launcher.py to connect its pipes (0 waits forever)"},
+    {"Pipes",  "SpawnService", "spawn-service", CONFIG_BOOL, offsetof(LauncherConfig, spawnService),
+     "Start scripts for Launcher.py and relay their output over the command pipe (0 or 1, needs Framing)"},
+    {"Pipes",  "SpawnRingSize", "spawn-ring-size", CONFIG_DWORD, offsetof(LauncherConfig, spawnRingSize),
+     "Shared-memory ring for spawned script output in bytes (rounded to a power of two), 0 uses the command pipe"},
+    // Repeated lines can be collapsed twice, on purpose. The coalescer (CoalesceWindowMs)
+    // collapses every run as it is read and reports it with a count and time range. The coalesce
+    // policy only compares lines still waiting in a throttled backlog. It is what collapses
+    // floods when the coalescer is off, and it also catches the coalescer's own output
+    // repeating while the UI is behind.
+    {"FlowControl", "Policy", "flow-policy", CONFIG_STRING, offsetof(LauncherConfig, flowPolicy),
+     "What a script flooding its output gets: block, coalesce or drop_oldest"},
+    {"FlowControl", "BudgetBytes", "flow-budget", CONFIG_DWORD, offsetof(LauncherConfig, flowBudgetBytes),
+     "Output backlog each script stream may hold before the policy applies"},
+    {"FlowControl", "RateBytesPerSecond", "flow-rate", CONFIG_DWORD, offsetof(LauncherConfig, flowRateBytes),
+     "Output each script stream may pass on to the UI per second, 0 for no limit"},
+    {"Log", "File", "log-file", CONFIG_STRING, offsetof(LauncherConfig, logFile),
+     "Memory-mapped rolling log all script output is copied to (empty disables)"},
+    {"Log", "SizeMB", "log-size-mb", CONFIG_DWORD, offsetof(LauncherConfig, logSizeMb),
+     "Size of the rolling log in MB, older output is overwritten"},
+    {"PostMortem", "Enabled", "post-mortem", CONFIG_BOOL, offsetof(LauncherConfig, postMortem),
+     "Write a minidump when Launcher.py hangs and the output tail when it crashes (0 or 1)"},
+    {"PostMortem", "HangSeconds", "hang-seconds", CONFIG_DWORD, offsetof(LauncherConfig, hangSeconds),
+     "Seconds without a UI heartbeat before Launcher.py is considered hung (0 disables dumps)"},
+    {"PostMortem", "TailKB", "post-mortem-tail-kb", CONFIG_DWORD, offsetof(LauncherConfig, postMortemTailKb),
+     "KB of recent output saved next to each capture"},
+    {"PostMortem", "Directory", "post-mortem-dir", CONFIG_STRING, offsetof(LauncherConfig, postMortemDirectory),
+     "Folder minidumps and output tails are written to"},
+    {"Supervisor", "Enabled", "supervise", CONFIG_BOOL, offsetof(LauncherConfig, supervise),
+     "Restart Launcher.py automatically when it exits with an error (0 or 1)"},
+    {"Supervisor", "RestartDelayMs", "restart-delay-ms", CONFIG_DWORD, offsetof(LauncherConfig, restartDelayMs),
+     "Delay before the first restart, doubled after each further failure"},
+    {"Supervisor", "MaxRestartDelayMs", "max-restart-delay-ms", CONFIG_DWORD, offsetof(LauncherConfig, maxRestartDelayMs),
+     "Longest delay between restarts"},
+    {"Supervisor", "MaxRestarts", "max-restarts", CONFIG_DWORD, offsetof(LauncherConfig, maxRestarts),
+     "Restarts in a row before giving up (0 for no limit)"},
+    {"Supervisor", "StableSeconds", "restart-stable-seconds", CONFIG_DWORD, offsetof(LauncherConfig, restartStableSeconds),
+     "A run lasting this long resets the restart delay and count"},
+    {"Shutdown", "DeadlineMs", "shutdown-deadline-ms", CONFIG_DWORD, offsetof(LauncherConfig, shutdownDeadlineMs),
+     "Wait this long for Launcher.py to finish shutting down before killing every process"},
+    {"Process", "PriorityClass", "priority", CONFIG_STRING, offsetof(LauncherConfig, priorityClass),
+     "Priority of Launcher.py and all scripts: idle, below_normal, normal, above_normal, high"},
+    {"Process", "AffinityMask", "affinity-mask", CONFIG_QWORD, offsetof(LauncherConfig, affinityMask),
+     "Bit mask of processors the Python tree may use, e.g. 0xFF00 (0 for all)"},
+    {"Process", "EcoQoS", "eco-qos", CONFIG_BOOL, offsetof(LauncherConfig, ecoQos),
+     "Run Python processes with EcoQoS power throttling (0 or 1)"},
+    {"Telemetry", "IntervalMs", "telemetry-interval-ms", CONFIG_DWORD, offsetof(LauncherConfig, telemetryIntervalMs),
+     "Per-process CPU/memory sampling interval for the Performance tab (0 disables)"},
+    {"Pool", "Size", "pool-size", CONFIG_DWORD, offsetof(LauncherConfig, poolSize),
+     "Pre-started Python interpreters kept ready for scripts (0 disables)"},
+    {"Pool", "Preload", "pool-preload", CONFIG_STRING, offsetof(LauncherConfig, poolPreload),
+     "Comma separated modules imported by idle pool interpreters"},
+    {"Profiling", "StartupProfile", "profile-startup", CONFIG_BOOL, offsetof(LauncherConfig, profileStartup),
+     "Record start-up phase timings to the startup trace file (0 or 1)"},
+    {"Profiling", "StartupProfileFile", "profile-startup-file", CONFIG_STRING, offsetof(LauncherConfig, startupProfilePath),
+     "CSV file the start-up trace is written to"},
+    {"Headless", "ScriptGroup", "headless", CONFIG_STRING, offsetof(LauncherConfig, headlessGroup),
+     "Run the scripts of a .script_group file without the UI, output prefixed in the console"},
+    {"Preflight", "Enabled", "preflight", CONFIG_BOOL, offsetof(LauncherConfig, preflight),
+     "Compile changed sources and prefetch the interpreter in the background at start-up (0 or 1)"},
+    {"Preflight", "CompileDirs", "preflight-compile-dirs", CONFIG_STRING, offsetof(LauncherConfig, preflightCompileDirs),
+     "Directories compiled when a .py file in them changed, separated by ';'"},
+    {"Preflight", "PrefetchMB", "preflight-prefetch-mb", CONFIG_DWORD, offsetof(LauncherConfig, preflightPrefetchMb),
+     "Interpreter zip, .pyc, .pyd and .dll data read into the file cache, in MB (0 disables)"},
+    {"Preflight", "StampFile", "preflight-stamp-file", CONFIG_STRING, offsetof(LauncherConfig, preflightStampFile),
+     "File recording the newest source the last compile covered"},
+    {"Instance", "SingleInstance", "single-instance", CONFIG_BOOL, offsetof(LauncherConfig, singleInstance),
+     "Send a second start's request to the running launcher and exit (0 or 1)"},
+    {"Instance", "OpenGroup", "open-group", CONFIG_STRING, offsetof(LauncherConfig, openGroup),
+     "Script group loaded once the UI is up, by the running launcher if there is one"},
+};
+
+#define CONFIG_OPTION_COUNT (sizeof(g_configOptions) / sizeof(g_configOptions[0]))
+
+// Fill a config with the built-in defaults.
+void initDefaultConfig(LauncherConfig *config)
+{
+    ZeroMemory(config, sizeof(*config));
+    strcpy(config->pythonPath, ".\\WinPython\\python-3.13.0rc1.amd64\\pythonw.exe");
+    strcpy(config->scriptPath, ".\\Launcher\\LauncherScript\\launcher.py");
+    config->pythonFlags[0] = '\0';
+    config->pythonOptimize = 0;
+    config->environment[0] = '\0';
+    config->readBufferSize = 4096;
+    config->outputRingSize = 256 * 1024;
+    config->outputFlushBytes = 16 * 1024;
+    config->outputFlushIntervalMs = 16;
+    config->coalesceWindowMs = 1000;
+    config->nativeAnsi = TRUE;
+    config->outputPipeBufferSize = 64 * 1024;
+    config->commandPipeBufferSize = 4096;
+    config->commandMessageMode = FALSE;
+    config->ipcFraming = TRUE;
+    config->connectTimeoutMs = 30000;
+    config->spawnService = TRUE;
+    config->spawnRingSize = 1024 * 1024;
+    strcpy(config->flowPolicy, "coalesce");
+    config->flowBudgetBytes = 64 * 1024;
+    config->flowRateBytes = 256 * 1024;
+    config->logFile[0] = '\0';
+    config->logSizeMb = 64;
+    config->postMortem = FALSE;
+    config->hangSeconds = 15;
+    config->postMortemTailKb = 64;
+    strcpy(config->postMortemDirectory, "PostMortem");
+    config->supervise = FALSE;
+    config->restartDelayMs = 250;
+    config->maxRestartDelayMs = 30000;
+    config->maxRestarts = 0;
+    config->restartStableSeconds = 60;
+    config->shutdownDeadlineMs = 3000;
+    config->priorityClass[0] = '\0';
+    config->affinityMask = 0;
+    config->ecoQos = FALSE;
+    config->telemetryIntervalMs = 500;
+    config->poolSize = 0;
+    strcpy(config->poolPreload, "json,threading,logging,subprocess,socket,queue,ctypes,tkinter,tkinter.ttk,psutil,numpy");
+    config->profileStartup = FALSE;
+    strcpy(config->startupProfilePath, "startup_profile.csv");
+    config->headlessGroup[0] = '\0';
+    config->preflight = FALSE;
+    strcpy(config->preflightCompileDirs, "Launcher;Lib;Scripts");
+    config->preflightPrefetchMb = 256;
+    strcpy(config->preflightStampFile, "compileall.stamp");
+    config->singleInstance = TRUE;
+    config->openGroup[0] = '\0';
+}
+
+// Parse a value for an option and store it in the config. Returns FALSE if malformed.
+static BOOL setConfigValue(LauncherConfig *config, const ConfigOption *option, const char *value)
+{
+    char *field = (char *)config + option->offset;
+
+    if (option->type == CONFIG_STRING)
+    {
+        if (strlen(value) >= CONFIG_STRING_SIZE)
+            return FALSE;
+        strcpy(field, value);
+        return TRUE;
+    }
+
+    char *end;
+    if (option->type == CONFIG_QWORD)
+    {
+        unsigned long long wide = strtoull(value, &end, 0);
+        if (*value == '\0' || *end != '\0')
+            return FALSE;
+        *(ULONGLONG *)field = wide;
+        return TRUE;
+    }
+
+    unsigned long number = strtoul(value, &end, 0);
+
+    if (*value == '\0' || *end != '\0')
+        return FALSE;
+    if (option->type == CONFIG_BOOL)
+        number = number != 0;
+
+    *(DWORD *)field = (DWORD)number;
+    return TRUE;
+}
+
+// Build the full path of the settings file next to the launcher exe.
+static BOOL getConfigFilePath(char *path, DWORD pathSize)
+{
+    DWORD length = GetModuleFileName(NULL, path, pathSize);
+    if (length == 0 || length >= pathSize)
+        return FALSE;
+
+    char *lastSlash = strrchr(path, '\\');
+    size_t directoryLength = lastSlash ? (size_t)(lastSlash - path + 1) : 0;
+    if (directoryLength + strlen(CONFIG_FILE_NAME) + 1 > pathSize)
+        return FALSE;
+
+    strcpy(path + directoryLength, CONFIG_FILE_NAME);
+    return TRUE;
+}
+
+// Apply every option present in the settings file.
+static void loadConfigFile(LauncherConfig *config, const char *path)
+{
+    if (GetFileAttributes(path) == INVALID_FILE_ATTRIBUTES)
+        return; // The settings file is optional
+
+    printf("[INFO] Loading settings from %s\n", path);
+    for (size_t i = 0; i < CONFIG_OPTION_COUNT; i++)
+    {
+        const ConfigOption *option = &g_configOptions[i];
+        char value[CONFIG_STRING_SIZE];
+
+        // A missing key reads back as the sentinel so that empty strings can still be set
+        GetPrivateProfileString(option->section, option->key, "\x01", value, sizeof(value), path);
+        if (strcmp(value, "\x01") == 0)
+            continue;
+        if ((value[0] || option->type == CONFIG_STRING) && !setConfigValue(config, option, value))
+            printf("[WARNING] Ignoring invalid value '%s' for [%s] %s\n", value, option->section, option->key);
+    }
+}
+
+// Keep sizes within workable bounds after user overrides.
+static void clampConfig(LauncherConfig *config)
+{
+    if (config->readBufferSize < 256)
+        config->readBufferSize = 256;
+    if (config->outputRingSize < config->readBufferSize)
+        config->outputRingSize = config->readBufferSize;
+    if (config->outputFlushBytes == 0 || config->outputFlushBytes > config->outputRingSize)
+        config->outputFlushBytes = config->outputRingSize;
+    if (config->outputPipeBufferSize < 4096)
+        config->outputPipeBufferSize = 4096;
+    if (config->commandPipeBufferSize < 4096)
+        config->commandPipeBufferSize = 4096;
+    if (config->flowBudgetBytes < 4096)
+        config->flowBudgetBytes = 4096; // Room for at least one pipe read
+    if (config->logSizeMb < 1)
+        config->logSizeMb = 1;
+    if (config->logSizeMb > 1024)
+        config->logSizeMb = 1024;
+    if (config->postMortemTailKb * 1024 > config->outputRingSize)
+        config->postMortemTailKb = config->outputRingSize / 1024; // The ring is all the history there is
+    if (config->maxRestartDelayMs < config->restartDelayMs)
+        config->maxRestartDelayMs = config->restartDelayMs;
+    if (config->shutdownDeadlineMs > 4500)
+        config->shutdownDeadlineMs = 4500; // Windows ends the process about 5 s after a close event
+    if (config->coalesceWindowMs > 0 && config->coalesceWindowMs < 50)
+        config->coalesceWindowMs = 50;
+    if (config->telemetryIntervalMs > 0 && config->telemetryIntervalMs < 50)
+        config->telemetryIntervalMs = 50;
+    if (config->pythonOptimize > 2)
+        config->pythonOptimize = 2;
+    if (config->preflightPrefetchMb > 4096)
+        config->preflightPrefetchMb = 4096;
+}
+
+// Find the option matching a command line argument such as "--read-buffer-size".
+static const ConfigOption *findConfigOption(const char *argument)
+{
+    if (strncmp(argument, "--", 2) != 0)
+        return NULL;
+
+    for (size_t i = 0; i < CONFIG_OPTION_COUNT; i++)
+    {
+        if (strcmp(argument + 2, g_configOptions[i].option) == 0)
+            return &g_configOptions[i];
+    }
+    return NULL;
+}
+
+// Apply settings from the settings file (if present) and then from the command line.
+BOOL loadConfig(LauncherConfig *config, int argc, char *argv[])
+{
+    char configPath[MAX_PATH];
+    const char *explicitPath = NULL;
+
+    // An explicit --config path replaces the default settings file
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (strcmp(argv[i], "--config") == 0)
+            explicitPath = argv[i + 1];
+    }
+
+    if (explicitPath)
+    {
+        if (!GetFullPathName(explicitPath, sizeof(configPath), configPath, NULL))
+            printf("[WARNING] Invalid settings file path: %s\n", explicitPath);
+        else if (GetFileAttributes(configPath) == INVALID_FILE_ATTRIBUTES)
+            printf("[WARNING] Settings file not found: %s\n", configPath);
+        else
+            loadConfigFile(config, configPath);
+    }
+    else if (getConfigFilePath(configPath, sizeof(configPath)))
+    {
+        loadConfigFile(config, configPath);
+    }
+
+    // Command line options take precedence over the settings file
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "/?") == 0)
+            return FALSE;
+
+        if (strcmp(argv[i], "--config") == 0)
+        {
+            i++;
+            continue;
+        }
+
+        // A bare file argument (a .script_group opened with the exe) is a group to open
+        if (strncmp(argv[i], "--", 2) != 0)
+        {
+            if (!setConfigValue(config, findConfigOption("--open-group"), argv[i]))
+                printf("[WARNING] Ignoring invalid script group path: %s\n", argv[i]);
+            continue;
+        }
+
+        // Boolean switches never take a value, so a group path after one is still the group:
+        // --name turns one on and --no-name turns it off
+        const ConfigOption *option = findConfigOption(argv[i]);
+        BOOL negated = FALSE;
+        if (!option && strncmp(argv[i], "--no-", 5) == 0)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "--%s", argv[i] + 5);
+            option = findConfigOption(name);
+            negated = option && option->type == CONFIG_BOOL;
+            if (!negated)
+                option = NULL;
+        }
+        if (!option)
+        {
+            printf("[WARNING] Unknown option: %s\n", argv[i]);
+            continue;
+        }
+
+        if (option->type == CONFIG_BOOL)
+        {
+            setConfigValue(config, option, negated ? "0" : "1");
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            printf("[WARNING] Missing value for option: %s\n", argv[i]);
+            continue;
+        }
+
+        if (!setConfigValue(config, option, argv[++i]))
+            printf("[WARNING] Ignoring invalid value '%s' for %s\n", argv[i], argv[i - 1]);
+    }
+
+    clampConfig(config);
+    return TRUE;
+}
+
+// Print the supported command line options.
+void printConfigUsage(void)
+{
+    printf("Usage: MSFS-PyScriptManager.exe [--config <file>] [options] [<file.script_group>]\n\n");
+    printf("Options (also settable in %s). Settings that are 0 or 1 in the file are switches\n", CONFIG_FILE_NAME);
+    printf("without a value on the command line: --<option> turns one on, --no-<option> off.\n");
+    for (size_t i = 0; i < CONFIG_OPTION_COUNT; i++)
+    {
+        const ConfigOption *option = &g_configOptions[i];
+        printf("  --%-22s [%s] %s\n      %s\n", option->option, option->section, option->key, option->description);
+    }
+}
+
+// Set the configured environment variables in the launcher's own environment.
+void applyConfigEnvironment(const LauncherConfig *config)
+{
+    char pairs[CONFIG_STRING_SIZE];
+    strcpy(pairs, config->environment);
+
+    for (char *pair = strtok(pairs, ";"); pair; pair = strtok(NULL, ";"))
+    {
+        char *equals = strchr(pair, '=');
+        if (!equals || equals == pair)
+        {
+            printf("[WARNING] Ignoring environment entry '%s', expected NAME=VALUE\n", pair);
+            continue;
+        }
+        *equals = '\0';
+        if (!SetEnvironmentVariable(pair, equals + 1))
+            printf("[WARNING] Failed to set environment variable %s. Error: %lu\n", pair, GetLastError());
+    }
+
+    if (config->pythonOptimize > 0)
+    {
+        char level[16];
+        snprintf(level, sizeof(level), "%lu", config->pythonOptimize);
+        SetEnvironmentVariable("PYTHONOPTIMIZE", level);
+    }
+}
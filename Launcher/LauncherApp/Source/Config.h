@@ -0,0 +1,80 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <windows.h>
+
+// Name of the optional settings file, looked up next to the launcher exe
+#define CONFIG_FILE_NAME "MSFS-PyScriptManager.ini"
+
+// Size of string settings, including the terminator
+#define CONFIG_STRING_SIZE 512
+
+// Tunable launcher settings. Defaults are filled in by initDefaultConfig and can be
+// overridden from the settings file and then from the command line.
+typedef struct
+{
+    char pythonPath[CONFIG_STRING_SIZE];   // Interpreter running Launcher.py, pool workers and headless scripts
+    char scriptPath[CONFIG_STRING_SIZE];   // The UI script (Launcher.py)
+    char pythonFlags[CONFIG_STRING_SIZE];  // Extra interpreter options for Launcher.py, e.g. "-X importtime"
+    DWORD pythonOptimize;        // PYTHONOPTIMIZE for every Python process, 0 leaves it alone
+    char environment[CONFIG_STRING_SIZE];  // NAME=VALUE pairs separated by ';' set for every Python process
+    DWORD readBufferSize;        // Bytes requested by each ReadFile on the output pipe
+    DWORD outputRingSize;        // Size of the console output ring buffer
+    DWORD outputFlushBytes;      // Flush the ring once this many bytes are pending
+    DWORD outputFlushIntervalMs; // Longest time output may sit in the ring before a flush
+    DWORD coalesceWindowMs;      // Collapse repeated script lines into a summary this often, 0 disables
+    BOOL nativeAnsi;             // Parse script escape codes into style runs before Launcher.py sees them
+    DWORD outputPipeBufferSize;  // Kernel buffer size of the script output pipe
+    DWORD commandPipeBufferSize; // Kernel buffer size of the command pipe
+    BOOL commandMessageMode;     // Use a message-mode command pipe (one command per read)
+    BOOL ipcFraming;             // Use length-prefixed frames with channel IDs on both pipes
+    DWORD connectTimeoutMs;      // Longest wait for Launcher.py to connect its pipes, 0 waits forever
+    BOOL spawnService;           // Start Launcher.py's scripts and relay their output (needs ipcFraming)
+    DWORD spawnRingSize;         // Shared-memory ring carrying the spawn service's output, 0 uses the command pipe
+    char flowPolicy[CONFIG_STRING_SIZE]; // What a flooding script stream does: block, coalesce or drop_oldest
+    DWORD flowBudgetBytes;       // Backlog each script stream may hold before the policy applies
+    DWORD flowRateBytes;         // Output each script stream may pass on per second, 0 for no limit
+    char logFile[CONFIG_STRING_SIZE]; // Rolling log file all pipe output is teed into, empty disables
+    DWORD logSizeMb;             // Size of the rolling log ring in MB
+    BOOL postMortem;             // Capture a minidump on UI hangs and the output tail on crashes
+    DWORD hangSeconds;           // UI heartbeat silence treated as a hang, 0 disables hang dumps
+    DWORD postMortemTailKb;      // Output kept next to each capture (KB)
+    char postMortemDirectory[CONFIG_STRING_SIZE]; // Folder captures are written to
+    BOOL supervise;              // Relaunch Launcher.py with backoff when it exits with an error
+    DWORD restartDelayMs;        // First restart delay, doubled after each failed run
+    DWORD maxRestartDelayMs;     // Upper bound of the restart delay
+    DWORD maxRestarts;           // Restarts before giving up, 0 for no limit
+    DWORD restartStableSeconds;  // A run lasting this long resets the restart delay
+    DWORD shutdownDeadlineMs;    // Wait for Launcher.py's shutdown acknowledgement before killing the job
+    char priorityClass[CONFIG_STRING_SIZE]; // Priority class of the Python tree, empty to inherit
+    ULONGLONG affinityMask;      // Processors the Python tree may run on, 0 for all
+    BOOL ecoQos;                 // Opt every Python process into EcoQoS power throttling
+    DWORD telemetryIntervalMs;   // Per-process CPU/memory sampling interval, 0 disables
+    DWORD poolSize;              // Pre-started interpreters kept ready for scripts, 0 disables
+    char poolPreload[CONFIG_STRING_SIZE]; // Comma separated modules imported by idle workers
+    BOOL profileStartup;         // Record start-up phase timestamps to a trace file
+    char startupProfilePath[CONFIG_STRING_SIZE]; // Where the start-up trace is written
+    char headlessGroup[CONFIG_STRING_SIZE]; // .script_group file run without the UI, empty runs Launcher.py
+    BOOL preflight;              // Compile changed sources and prefetch the interpreter at start-up
+    char preflightCompileDirs[CONFIG_STRING_SIZE]; // Directories compiled by the preflight, separated by ';'
+    DWORD preflightPrefetchMb;   // Interpreter files read into the file cache, 0 disables
+    char preflightStampFile[CONFIG_STRING_SIZE]; // Records the sources the last compile covered
+    BOOL singleInstance;         // Hand a second start's request to the running launcher instead
+    char openGroup[CONFIG_STRING_SIZE]; // .script_group file loaded into the UI once it is up
+} LauncherConfig;
+
+// Fill a config with the built-in defaults.
+void initDefaultConfig(LauncherConfig *config);
+
+// Apply settings from the settings file (if present) and then from the command line.
+// Prints a warning for unknown or malformed options. Returns FALSE if "--help" was given.
+BOOL loadConfig(LauncherConfig *config, int argc, char *argv[]);
+
+// Print the supported command line options.
+void printConfigUsage(void);
+
+// Set the configured environment variables (and PYTHONOPTIMIZE) in the launcher's own
+// environment, which every Python process it starts inherits.
+void applyConfigEnvironment(const LauncherConfig *config);
+
+#endif // CONFIG_H
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ConsoleWriter.h"
+
+// Allocate the ring and bind the writer to the process's stdout.
+BOOL initConsoleWriter(ConsoleWriter *writer, DWORD capacity, DWORD flushBytes, DWORD flushIntervalMs)
+{
+    DWORD mode;
+
+    ZeroMemory(writer, sizeof(*writer));
+    writer->output = GetStdHandle(STD_OUTPUT_HANDLE);
+    writer->isConsole = GetConsoleMode(writer->output, &mode);
+    writer->capacity = capacity;
+    writer->flushBytes = flushBytes < capacity ? flushBytes : capacity;
+    writer->flushIntervalMs = flushIntervalMs;
+    writer->ring = (char *)malloc(capacity);
+    return writer->ring != NULL;
+}
+
+// Write a contiguous block straight to the output handle.
+static void writeBlock(ConsoleWriter *writer, const char *data, DWORD length)
+{
+    while (length > 0)
+    {
+        DWORD written = 0;
+        BOOL ok = writer->isConsole
+            ? WriteConsoleA(writer->output, data, length, &written, NULL)
+            : WriteFile(writer->output, data, length, &written, NULL);
+        if (!ok || written == 0)
+            return; // Nothing sensible left to report to
+        data += written;
+        length -= written;
+    }
+}
+
+// Copy data into the ring at the current write position, wrapping as required.
+static void copyIntoRing(ConsoleWriter *writer, const char *data, DWORD length)
+{
+    DWORD offset = (DWORD)(writer->writePos % writer->capacity);
+    DWORD firstPart = writer->capacity - offset;
+    if (firstPart > length)
+        firstPart = length;
+
+    CopyMemory(writer->ring + offset, data, firstPart);
+    CopyMemory(writer->ring, data + firstPart, length - firstPart);
+    writer->writePos += length;
+}
+
+// Append data (may contain embedded NULs). Flushes first if the data would not fit.
+void consoleWriterAppend(ConsoleWriter *writer, const char *data, DWORD length)
+{
+    if (length == 0)
+        return;
+
+    if (writer->writePos - writer->flushedPos + length > writer->capacity)
+        consoleWriterFlush(writer);
+
+    if (length >= writer->capacity)
+    {
+        // Too big to batch - write it directly, keeping only the tail as history
+        writeBlock(writer, data, length);
+        copyIntoRing(writer, data + length - writer->capacity, writer->capacity);
+        writer->writePos += length - writer->capacity;
+        writer->flushedPos = writer->writePos;
+        return;
+    }
+
+    if (writer->writePos == writer->flushedPos)
+        writer->pendingSinceTick = GetTickCount();
+
+    copyIntoRing(writer, data, length);
+}
+
+// Write all pending bytes to the console. A batch is one write unless it wraps the ring.
+void consoleWriterFlush(ConsoleWriter *writer)
+{
+    DWORD pending = (DWORD)(writer->writePos - writer->flushedPos);
+    if (pending == 0)
+        return;
+
+    // Keep ordering with anything printed through the CRT
+    fflush(stdout);
+
+    DWORD offset = (DWORD)(writer->flushedPos % writer->capacity);
+    DWORD firstPart = writer->capacity - offset;
+    if (firstPart > pending)
+        firstPart = pending;
+
+    writeBlock(writer, writer->ring + offset, firstPart);
+    if (pending > firstPart)
+        writeBlock(writer, writer->ring, pending - firstPart);
+
+    writer->flushedPos = writer->writePos;
+}
+
+// Flush if the size threshold is reached or the pending data is older than the interval.
+void consoleWriterFlushIfDue(ConsoleWriter *writer)
+{
+    if (writer->writePos - writer->flushedPos >= writer->flushBytes || consoleWriterTimeout(writer) == 0)
+        consoleWriterFlush(writer);
+}
+
+// Milliseconds until pending data must be flushed, or INFINITE if nothing is pending.
+DWORD consoleWriterTimeout(const ConsoleWriter *writer)
+{
+    if (writer->writePos == writer->flushedPos)
+        return INFINITE;
+
+    DWORD elapsed = GetTickCount() - writer->pendingSinceTick;
+    return elapsed >= writer->flushIntervalMs ? 0 : writer->flushIntervalMs - elapsed;
+}
+
+// Copy up to maxLength of the most recent output into out, oldest first.
+DWORD consoleWriterCopyTail(const ConsoleWriter *writer, char *out, DWORD maxLength)
+{
+    ULONGLONG available = writer->writePos < writer->capacity ? writer->writePos : writer->capacity;
+    DWORD length = available < maxLength ? (DWORD)available : maxLength;
+
+    DWORD offset = (DWORD)((writer->writePos - length) % writer->capacity);
+    DWORD firstPart = writer->capacity - offset;
+    if (firstPart > length)
+        firstPart = length;
+
+    CopyMemory(out, writer->ring + offset, firstPart);
+    CopyMemory(out + firstPart, writer->ring, length - firstPart);
+    return length;
+}
+
+// Flush and free the ring.
+void closeConsoleWriter(ConsoleWriter *writer)
+{
+    if (writer->ring)
+    {
+        consoleWriterFlush(writer);
+        free(writer->ring);
+        writer->ring = NULL;
+    }
+}
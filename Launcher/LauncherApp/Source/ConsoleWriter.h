@@ -0,0 +1,46 @@
+#ifndef CONSOLE_WRITER_H
+#define CONSOLE_WRITER_H
+
+#include <windows.h>
+
+// Batches pipe output in a ring buffer and writes it to the console with as few
+// WriteConsoleA/WriteFile calls as possible. Flushed bytes stay in the ring until they are
+// overwritten, so the ring also holds the most recent output.
+typedef struct
+{
+    HANDLE output;              // Destination (the launcher's stdout)
+    BOOL isConsole;             // TRUE to use WriteConsoleA, FALSE for WriteFile (redirected)
+    char *ring;                 // Ring storage
+    DWORD capacity;             // Ring size in bytes
+    ULONGLONG writePos;         // Total bytes appended
+    ULONGLONG flushedPos;       // Total bytes written out
+    DWORD flushBytes;           // Flush as soon as this many bytes are pending
+    DWORD flushIntervalMs;      // Longest time a byte may stay pending
+    DWORD pendingSinceTick;     // Tick count when the oldest pending byte was appended
+} ConsoleWriter;
+
+// Allocate the ring and bind the writer to the process's stdout.
+// Returns FALSE if the ring could not be allocated.
+BOOL initConsoleWriter(ConsoleWriter *writer, DWORD capacity, DWORD flushBytes, DWORD flushIntervalMs);
+
+// Append data (may contain embedded NULs). Flushes first if the data would not fit.
+void consoleWriterAppend(ConsoleWriter *writer, const char *data, DWORD length);
+
+// Write all pending bytes to the console.
+void consoleWriterFlush(ConsoleWriter *writer);
+
+// Flush if the size threshold is reached or the pending data is older than the interval.
+void consoleWriterFlushIfDue(ConsoleWriter *writer);
+
+// Milliseconds until pending data must be flushed, or INFINITE if nothing is pending.
+// Intended as the timeout of the main loop's wait.
+DWORD consoleWriterTimeout(const ConsoleWriter *writer);
+
+// Copy up to maxLength of the most recent output (flushed or not) into out, oldest first.
+// Returns the number of bytes copied.
+DWORD consoleWriterCopyTail(const ConsoleWriter *writer, char *out, DWORD maxLength);
+
+// Flush and free the ring.
+void closeConsoleWriter(ConsoleWriter *writer);
+
+#endif // CONSOLE_WRITER_H
@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FlowControl.h"
+
+// Room reserved for a "repeated" or "suppressed" marker line
+#define FLOW_MARKER_SIZE 64
+
+// Least output worth passing on while the rate budget refills, so a throttled stream goes out
+// in a few larger chunks instead of many tiny ones
+#define FLOW_MIN_SEND 512
+
+// Translate a policy name from the settings.
+BOOL parseFlowPolicy(const char *name, FlowPolicy *policy)
+{
+    static const struct
+    {
+        const char *name;
+        FlowPolicy policy;
+    } policies[] = {
+        {"block", FLOW_POLICY_BLOCK},
+        {"coalesce", FLOW_POLICY_COALESCE},
+        {"drop_oldest", FLOW_POLICY_DROP_OLDEST},
+    };
+
+    for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++)
+    {
+        if (_stricmp(name, policies[i].name) == 0)
+        {
+            *policy = policies[i].policy;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Allocate a stream's backlog.
+BOOL initFlowStream(FlowStream *stream, const FlowSettings *settings)
+{
+    ZeroMemory(stream, sizeof(*stream));
+    stream->backlog = (char *)malloc(settings->budgetBytes);
+    if (!stream->backlog)
+        return FALSE;
+
+    stream->policy = settings->policy;
+    stream->rate = settings->rateBytesPerSecond;
+    stream->capacity = settings->budgetBytes;
+    stream->allocated = settings->budgetBytes;
+    stream->tokens = stream->capacity; // A quiet stream may burst up to its budget
+    stream->lastRefill = GetTickCount();
+    return TRUE;
+}
+
+// Release the backlog.
+void closeFlowStream(FlowStream *stream)
+{
+    free(stream->backlog);
+    stream->backlog = NULL;
+    stream->allocated = 0;
+    stream->used = 0;
+}
+
+// Bytes waiting to go out, with room for pending markers.
+static DWORD pendingBytes(const FlowStream *stream)
+{
+    return stream->used + (stream->droppedLines ? FLOW_MARKER_SIZE : 0) + (stream->repeats ? FLOW_MARKER_SIZE : 0);
+}
+
+// Tokens needed before a throttled stream passes output on.
+static DWORD sendThreshold(const FlowStream *stream)
+{
+    DWORD pending = pendingBytes(stream);
+    return pending < FLOW_MIN_SEND ? pending : FLOW_MIN_SEND;
+}
+
+// Add the tokens earned since the last refill, up to one budget's worth.
+static void refillTokens(FlowStream *stream)
+{
+    if (!stream->rate)
+        return;
+
+    DWORD now = GetTickCount();
+    ULONGLONG added = (ULONGLONG)(now - stream->lastRefill) * stream->rate / 1000;
+    if (added == 0)
+        return; // Keep the fraction for the next refill
+    stream->lastRefill = now;
+
+    ULONGLONG tokens = stream->tokens + added;
+    stream->tokens = tokens > stream->capacity ? stream->capacity : (DWORD)tokens;
+}
+
+// Remove bytes from the front of the backlog and move the line offsets along.
+static void discardFront(FlowStream *stream, DWORD count)
+{
+    memmove(stream->backlog, stream->backlog + count, stream->used - count);
+    stream->used -= count;
+    stream->lineStart = stream->lineStart > count ? stream->lineStart - count : 0;
+
+    if (stream->hasLastLine && stream->lastLineStart < count)
+        stream->hasLastLine = FALSE; // Already gone, nothing left to coalesce with
+    else if (stream->hasLastLine)
+        stream->lastLineStart -= count;
+}
+
+// Drop whole lines from the front until needed bytes fit. needed is at most the capacity.
+static void makeRoom(FlowStream *stream, DWORD needed)
+{
+    DWORD room = stream->used < stream->capacity ? stream->capacity - stream->used : 0;
+    if (room >= needed)
+        return;
+
+    // Find the cut with one scan and move the rest once
+    DWORD excess = needed - room;
+    DWORD cut = 0;
+    while (cut < excess)
+    {
+        const char *newline = (const char *)memchr(stream->backlog + cut, '\n', stream->used - cut);
+        stream->droppedLines++;
+        if (!newline)
+        {
+            cut = stream->used; // One unfinished line, it goes as a whole
+            break;
+        }
+        cut = (DWORD)(newline - stream->backlog) + 1;
+    }
+    discardFront(stream, cut);
+}
+
+// Enlarge the backlog to hold needed bytes. Returns FALSE if out of memory.
+static BOOL growBacklog(FlowStream *stream, DWORD needed)
+{
+    if (needed <= stream->allocated)
+        return TRUE;
+
+    DWORD size = stream->allocated * 2 > needed ? stream->allocated * 2 : needed;
+    char *backlog = (char *)realloc(stream->backlog, size);
+    if (!backlog)
+        return FALSE;
+    stream->backlog = backlog;
+    stream->allocated = size;
+    return TRUE;
+}
+
+// Append bytes to the backlog, dropping the oldest lines when it is full. The block policy
+// grows it instead, and drops only if that runs out of memory.
+static void appendBytes(FlowStream *stream, const char *data, DWORD length)
+{
+    if (stream->policy == FLOW_POLICY_BLOCK && growBacklog(stream, stream->used + length))
+    {
+        memcpy(stream->backlog + stream->used, data, length);
+        stream->used += length;
+        return;
+    }
+
+    if (length > stream->capacity)
+    {
+        // Only the newest part of the data fits at all
+        DWORD skipped = length - stream->capacity;
+        for (DWORD i = 0; i < skipped; i++)
+        {
+            if (data[i] == '\n')
+                stream->droppedLines++;
+        }
+        data += skipped;
+        length = stream->capacity;
+    }
+
+    makeRoom(stream, length);
+    memcpy(stream->backlog + stream->used, data, length);
+    stream->used += length;
+}
+
+// Store the "repeated" marker of the last line before anything else is queued after it.
+static void flushRepeats(FlowStream *stream)
+{
+    char marker[FLOW_MARKER_SIZE];
+
+    if (!stream->repeats)
+        return;
+
+    int length = snprintf(marker, sizeof(marker), "[Previous line repeated %lu more times]\n", stream->repeats);
+    stream->repeats = 0;
+    appendBytes(stream, marker, (DWORD)length);
+    stream->hasLastLine = FALSE; // The marker is not a line to coalesce with
+    stream->lineStart = stream->used;
+}
+
+// TRUE if the policy lets length more bytes be read now.
+BOOL flowStreamCanRead(const FlowStream *stream, DWORD length)
+{
+    return stream->policy != FLOW_POLICY_BLOCK ||
+           (stream->used <= stream->capacity && stream->capacity - stream->used >= length);
+}
+
+// Queue output read from the script.
+void flowStreamPut(FlowStream *stream, const char *data, DWORD length)
+{
+    while (length > 0)
+    {
+        const char *newline = (const char *)memchr(data, '\n', length);
+        DWORD segment = newline ? (DWORD)(newline - data) + 1 : length;
+
+        // A complete line equal to the last queued one only bumps the repeat count
+        if (newline && stream->policy == FLOW_POLICY_COALESCE && stream->hasLastLine &&
+            stream->lineStart == stream->used && stream->used - stream->lastLineStart == segment &&
+            memcmp(stream->backlog + stream->lastLineStart, data, segment) == 0)
+        {
+            stream->repeats++;
+        }
+        else
+        {
+            flushRepeats(stream);
+            appendBytes(stream, data, segment);
+            if (newline)
+            {
+                stream->lastLineStart = stream->lineStart;
+                stream->hasLastLine = TRUE;
+                stream->lineStart = stream->used;
+            }
+        }
+
+        data += segment;
+        length -= segment;
+    }
+}
+
+// Copy out what the rate budget allows.
+DWORD flowStreamTake(FlowStream *stream, char *output, DWORD size)
+{
+    DWORD copied = 0;
+
+    if (pendingBytes(stream) == 0)
+        return 0;
+
+    refillTokens(stream);
+    if (stream->rate && stream->tokens < sendThreshold(stream))
+        return 0;
+    DWORD budget = stream->rate ? stream->tokens : MAXDWORD;
+
+    // Lines dropped before the queued output are reported ahead of it
+    if (stream->droppedLines)
+    {
+        int length = snprintf(output, size, "[%lu lines suppressed]\n", stream->droppedLines);
+        if (length > 0 && (DWORD)length < size)
+        {
+            copied = (DWORD)length;
+            stream->droppedLines = 0;
+        }
+    }
+
+    DWORD count = stream->used;
+    if (count > size - copied)
+        count = size - copied;
+    if (copied + count > budget)
+        count = budget > copied ? budget - copied : 0;
+    if (count < stream->used)
+    {
+        // Stop at a line end when there is one, the rest goes with the next take
+        DWORD lineEnd = count;
+        while (lineEnd > 0 && stream->backlog[lineEnd - 1] != '\n')
+            lineEnd--;
+        if (lineEnd > 0)
+            count = lineEnd;
+    }
+
+    memcpy(output + copied, stream->backlog, count);
+    copied += count;
+    discardFront(stream, count);
+
+    // Repeats of the line that just went out follow it
+    if (stream->used == 0 && stream->repeats)
+    {
+        int length = snprintf(output + copied, size - copied, "[Previous line repeated %lu more times]\n",
+                              stream->repeats);
+        if (length > 0 && (DWORD)length < size - copied)
+        {
+            copied += (DWORD)length;
+            stream->repeats = 0;
+        }
+    }
+
+    if (stream->rate)
+        stream->tokens = stream->tokens > copied ? stream->tokens - copied : 0;
+    return copied;
+}
+
+// Milliseconds until more output may be passed on.
+DWORD flowStreamDelayMs(FlowStream *stream)
+{
+    if (pendingBytes(stream) == 0)
+        return INFINITE;
+    if (!stream->rate)
+        return 0;
+
+    refillTokens(stream);
+    DWORD threshold = sendThreshold(stream);
+    if (stream->tokens >= threshold)
+        return 0;
+    return (DWORD)((ULONGLONG)(threshold - stream->tokens) * 1000 / stream->rate) + 1;
+}
+
+// TRUE once everything queued has been passed on.
+BOOL flowStreamIdle(const FlowStream *stream)
+{
+    return pendingBytes(stream) == 0;
+}
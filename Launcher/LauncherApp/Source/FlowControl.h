@@ -0,0 +1,69 @@
+#ifndef FLOW_CONTROL_H
+#define FLOW_CONTROL_H
+
+#include <windows.h>
+
+// What a stream does once a script writes faster than its budget lets output through
+typedef enum
+{
+    FLOW_POLICY_BLOCK,       // Stop reading the script's pipe, so its writes block until the backlog drains
+    FLOW_POLICY_COALESCE,    // Collapse identical consecutive lines, then drop the oldest lines
+    FLOW_POLICY_DROP_OLDEST, // Drop the oldest lines and report how many were suppressed
+} FlowPolicy;
+
+// Flow control settings shared by every stream of a relay
+typedef struct
+{
+    FlowPolicy policy;
+    DWORD budgetBytes;        // Backlog a stream may hold while waiting for its rate budget
+    DWORD rateBytesPerSecond; // Output a stream may pass on per second, 0 for no limit
+} FlowSettings;
+
+// One script output stream between its pipe and Launcher.py. Output is queued in a bounded
+// backlog and passed on at most rateBytesPerSecond, with bursts up to budgetBytes.
+typedef struct
+{
+    FlowPolicy policy;
+    DWORD rate;               // Bytes per second, 0 for no limit
+    char *backlog;            // Output not passed on yet
+    DWORD capacity;           // The byte budget
+    DWORD allocated;          // Size of backlog, more than capacity once block policy output outgrew it
+    DWORD used;
+    DWORD lineStart;          // Offset of the line still being written (after the last newline)
+    DWORD lastLineStart;      // Offset of the last complete line, valid while hasLastLine
+    BOOL hasLastLine;
+    DWORD repeats;            // Copies of the last line not stored (coalesce policy)
+    DWORD droppedLines;       // Lines dropped since the last "suppressed" marker
+    DWORD tokens;             // Bytes that may be passed on now
+    DWORD lastRefill;         // Tick count tokens were last added at
+} FlowStream;
+
+// Translate "block", "coalesce" or "drop_oldest" into a policy. Returns FALSE for an unknown name.
+BOOL parseFlowPolicy(const char *name, FlowPolicy *policy);
+
+// Allocate a stream's backlog. Returns FALSE if out of memory.
+BOOL initFlowStream(FlowStream *stream, const FlowSettings *settings);
+
+// Release the backlog.
+void closeFlowStream(FlowStream *stream);
+
+// TRUE if length more bytes may be read from the script. Always TRUE unless the policy is
+// FLOW_POLICY_BLOCK, which holds reads while the backlog lacks room for them.
+BOOL flowStreamCanRead(const FlowStream *stream, DWORD length);
+
+// Queue output read from the script, coalescing or dropping lines as the policy says. Under
+// FLOW_POLICY_BLOCK nothing is dropped: output that grew past the room reserved for the read
+// (the coalescer's summary lines) enlarges the backlog, and reads stay held until it drains.
+void flowStreamPut(FlowStream *stream, const char *data, DWORD length);
+
+// Copy out as much queued output as the rate budget allows, at most size bytes, markers for
+// repeated and suppressed lines included. Returns the bytes copied, 0 when nothing may go now.
+DWORD flowStreamTake(FlowStream *stream, char *output, DWORD size);
+
+// Milliseconds until flowStreamTake can pass more output on, INFINITE if nothing is queued.
+DWORD flowStreamDelayMs(FlowStream *stream);
+
+// TRUE once everything queued has been passed on.
+BOOL flowStreamIdle(const FlowStream *stream);
+
+#endif // FLOW_CONTROL_H
@@ -0,0 +1,522 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Headless.h"
+#include "Coalescer.h"
+#include "CommandLine.h"
+#include "ConsoleWriter.h"
+#include "PipeReader.h"
+#include "JobObject.h"
+#include "ProcessPolicy.h"
+#include "RingLog.h"
+
+// Library folder Launcher.py adds to PYTHONPATH for every script
+#define HEADLESS_LIB_PATH ".\\Launcher\\Lib"
+
+// Console writer and optional rolling log shared by every script
+typedef struct
+{
+    ConsoleWriter writer;
+    RingLog log;
+    BOOL logOpen;
+} HeadlessOutput;
+
+// One output pipe of a script, with the part of the current line not printed yet
+typedef struct
+{
+    PipeReader reader;
+    HANDLE pipe;
+    BOOL isError;               // stderr: flushed straight away and tagged in the prefix
+    HeadlessOutput *output;
+    const char *scriptName;     // Output prefix
+    Coalescer coalescer;        // Collapses repeated lines before they are split and printed
+    char line[HEADLESS_LINE_SIZE];
+    DWORD lineLength;
+} HeadlessStream;
+
+// A script from the group and its process
+typedef struct
+{
+    char path[MAX_PATH];
+    char name[64];              // File name without extension, used as output prefix
+    HeadlessStream output;
+    HeadlessStream error;
+    PROCESS_INFORMATION pi;
+    BOOL running;
+} HeadlessScript;
+
+static void headlessWrite(HeadlessOutput *output, const char *data, DWORD length)
+{
+    if (output->logOpen)
+        ringLogWrite(&output->log, data, length);
+    consoleWriterAppend(&output->writer, data, length);
+}
+
+// Print one line (without its newline) behind the script's prefix.
+static void emitLine(const HeadlessStream *stream, const char *line, DWORD length)
+{
+    char prefix[96];
+    int prefixLength = snprintf(prefix, sizeof(prefix), stream->isError ? "[%s:stderr] " : "[%s] ",
+                                stream->scriptName);
+
+    headlessWrite(stream->output, prefix, (DWORD)prefixLength);
+    headlessWrite(stream->output, line, length);
+    headlessWrite(stream->output, "\n", 1);
+}
+
+// Length of a line without a trailing carriage return
+static DWORD lineLengthWithoutCr(const char *line, DWORD length)
+{
+    return length && line[length - 1] == '\r' ? length - 1 : length;
+}
+
+// Split relayed data into lines. Complete lines are printed straight from the read buffer;
+// only a trailing partial line is copied, so lines of different scripts never interleave.
+// Also the coalescer's output callback.
+static void relayLines(void *context, const char *data, DWORD length)
+{
+    HeadlessStream *stream = (HeadlessStream *)context;
+
+    while (length > 0)
+    {
+        const char *newline = (const char *)memchr(data, '\n', length);
+        DWORD chunk = newline ? (DWORD)(newline - data) : length;
+
+        if (newline && !stream->lineLength)
+        {
+            emitLine(stream, data, lineLengthWithoutCr(data, chunk));
+        }
+        else
+        {
+            // Lines longer than the buffer are printed in pieces
+            DWORD room = HEADLESS_LINE_SIZE - stream->lineLength;
+            if (chunk > room)
+            {
+                chunk = room;
+                newline = NULL;
+            }
+            memcpy(stream->line + stream->lineLength, data, chunk);
+            stream->lineLength += chunk;
+
+            if (newline || stream->lineLength == HEADLESS_LINE_SIZE)
+            {
+                emitLine(stream, stream->line, lineLengthWithoutCr(stream->line, stream->lineLength));
+                stream->lineLength = 0;
+            }
+        }
+
+        DWORD consumed = chunk + (newline ? 1 : 0);
+        data += consumed;
+        length -= consumed;
+    }
+}
+
+// Print held back repeats and whatever is left of the stream's last line once its pipe has closed.
+static void finishStream(HeadlessStream *stream)
+{
+    coalescerFlush(&stream->coalescer);
+    if (stream->lineLength)
+    {
+        emitLine(stream, stream->line, stream->lineLength);
+        stream->lineLength = 0;
+    }
+}
+
+// Relay a completed read and queue the next one, with the flush policy of the UI launcher:
+// stderr right away, stdout once the pipe is drained or the batch is due.
+static void relayStream(HeadlessStream *stream)
+{
+    DWORD bytesRead = completePipeRead(&stream->reader);
+    if (stream->coalescer.windowMs)
+        coalescerFeed(&stream->coalescer, stream->reader.buffer, bytesRead);
+    else
+        relayLines(stream, stream->reader.buffer, bytesRead);
+    beginPipeRead(&stream->reader);
+
+    if (stream->reader.closed)
+        finishStream(stream);
+
+    if (stream->isError || !stream->reader.pending ||
+        WaitForSingleObject(stream->reader.overlapped.hEvent, 0) != WAIT_OBJECT_0)
+        consoleWriterFlush(&stream->output->writer);
+    else
+        consoleWriterFlushIfDue(&stream->output->writer);
+}
+
+// Remove leading and trailing whitespace in place.
+static char *trimLine(char *line)
+{
+    while (*line == ' ' || *line == '\t')
+        line++;
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == '\n' ||
+                          line[length - 1] == ' ' || line[length - 1] == '\t'))
+        line[--length] = '\0';
+    return line;
+}
+
+// Read the group file into scripts, resolving paths against the file's folder and skipping
+// duplicates and missing files. Returns the number of scripts.
+static DWORD loadScriptGroup(const char *groupPath, HeadlessScript *scripts, DWORD maxScripts)
+{
+    char fullGroupPath[MAX_PATH];
+    if (!GetFullPathName(groupPath, sizeof(fullGroupPath), fullGroupPath, NULL))
+    {
+        printf("[ERROR] Invalid script group path: %s\n", groupPath);
+        return 0;
+    }
+
+    FILE *file = fopen(fullGroupPath, "r");
+    if (!file)
+    {
+        printf("[ERROR] Script group file '%s' not found.\n", fullGroupPath);
+        return 0;
+    }
+
+    char groupDir[MAX_PATH];
+    strcpy(groupDir, fullGroupPath);
+    char *lastSlash = strrchr(groupDir, '\\');
+    if (lastSlash)
+        lastSlash[1] = '\0';
+    else
+        groupDir[0] = '\0';
+
+    DWORD count = 0;
+    char buffer[MAX_PATH * 2];
+    while (fgets(buffer, sizeof(buffer), file))
+    {
+        char *line = trimLine(buffer);
+        if (!*line)
+            continue;
+        if (count == maxScripts)
+        {
+            printf("[WARNING] Only the first %lu scripts of the group are run headless.\n", maxScripts);
+            break;
+        }
+
+        // Paths are written relative to the group file but absolute ones are accepted too
+        char combined[MAX_PATH * 2];
+        BOOL absolute = line[0] == '\\' || line[0] == '/' || (line[0] && line[1] == ':');
+        snprintf(combined, sizeof(combined), "%s%s", absolute ? "" : groupDir, line);
+
+        HeadlessScript *script = &scripts[count];
+        if (!GetFullPathName(combined, sizeof(script->path), script->path, NULL))
+        {
+            printf("[ERROR] Invalid script path in group: %s\n", line);
+            continue;
+        }
+        if (GetFileAttributes(script->path) == INVALID_FILE_ATTRIBUTES)
+        {
+            printf("[ERROR] Script '%s' not found.\n", script->path);
+            continue;
+        }
+
+        BOOL duplicate = FALSE;
+        for (DWORD i = 0; i < count && !duplicate; i++)
+            duplicate = _stricmp(scripts[i].path, script->path) == 0;
+        if (duplicate)
+            continue;
+
+        const char *fileName = strrchr(script->path, '\\');
+        fileName = fileName ? fileName + 1 : script->path;
+        snprintf(script->name, sizeof(script->name), "%s", fileName);
+        char *extension = strrchr(script->name, '.');
+        if (extension)
+            *extension = '\0';
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+// Create an inbound overlapped pipe for one stream and open its inheritable client end.
+static BOOL createStreamPipe(HeadlessStream *stream, DWORD index, const char *kind,
+                             const LauncherConfig *config, HANDLE *client)
+{
+    char pipeName[128];
+    snprintf(pipeName, sizeof(pipeName), "\\\\.\\pipe\\MSFSPyScriptManagerHeadless_%lu_%d_%lu_%s",
+             GetCurrentProcessId(), rand(), index, kind);
+
+    stream->pipe = CreateNamedPipe(pipeName, PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED,
+                                   PIPE_TYPE_BYTE | PIPE_WAIT, 1, config->outputPipeBufferSize,
+                                   config->outputPipeBufferSize, 0, NULL);
+    if (stream->pipe == INVALID_HANDLE_VALUE)
+    {
+        stream->pipe = NULL;
+        printf("[ERROR] Failed to create named pipe: %s Error: %lu\n", pipeName, GetLastError());
+        return FALSE;
+    }
+
+    SECURITY_ATTRIBUTES sa = {sizeof(SECURITY_ATTRIBUTES), NULL, TRUE};
+    *client = CreateFile(pipeName, GENERIC_WRITE, 0, &sa, OPEN_EXISTING, 0, NULL);
+    if (*client == INVALID_HANDLE_VALUE)
+    {
+        *client = NULL;
+        printf("[ERROR] Failed to open pipe client: %s Error: %lu\n", pipeName, GetLastError());
+        return FALSE;
+    }
+
+    if (!initPipeReader(&stream->reader, stream->pipe, config->readBufferSize))
+    {
+        printf("[ERROR] Failed to allocate the pipe reader for %s.\n", pipeName);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Start one script in the job with its stdout and stderr on their own pipes.
+static BOOL startHeadlessScript(HeadlessScript *script, DWORD index, const char *pythonPath, HANDLE job,
+                                HeadlessOutput *output, const LauncherConfig *config)
+{
+    HANDLE outputClient = NULL;
+    HANDLE errorClient = NULL;
+    BOOL started = FALSE;
+
+    HeadlessStream *streams[] = {&script->output, &script->error};
+    for (int s = 0; s < 2; s++)
+    {
+        streams[s]->isError = s == 1;
+        streams[s]->output = output;
+        streams[s]->scriptName = script->name;
+        initCoalescer(&streams[s]->coalescer, config->coalesceWindowMs, relayLines, streams[s]);
+    }
+    if (createStreamPipe(&script->output, index, "out", config, &outputClient) &&
+        createStreamPipe(&script->error, index, "err", config, &errorClient))
+    {
+        CommandLine commandLine;
+        initCommandLine(&commandLine);
+        appendCommandLineArgument(&commandLine, pythonPath);
+        appendCommandLine(&commandLine, " -u");
+        appendCommandLineArgument(&commandLine, script->path);
+
+        STARTUPINFO si = {sizeof(STARTUPINFO)};
+        si.dwFlags = STARTF_USESTDHANDLES;
+        si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+        si.hStdOutput = outputClient;
+        si.hStdError = errorClient;
+
+        if (commandLineReady(&commandLine))
+        {
+            started = job
+                ? createProcessInJob(job, commandLine.text, 0, &si, &script->pi)
+                : CreateProcess(NULL, commandLine.text, NULL, NULL, TRUE, 0, NULL, NULL, &si, &script->pi);
+        }
+        else
+        {
+            SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+        }
+        freeCommandLine(&commandLine);
+        if (!started)
+            printf("[ERROR] Failed to start %s. Error: %lu\n", script->path, GetLastError());
+    }
+
+    // The script holds its own copies; ours would keep the pipes from breaking when it exits
+    if (outputClient)
+        CloseHandle(outputClient);
+    if (errorClient)
+        CloseHandle(errorClient);
+
+    if (!started)
+        return FALSE;
+
+    CloseHandle(script->pi.hThread);
+    script->pi.hThread = NULL;
+    script->running = TRUE;
+    beginPipeRead(&script->output.reader);
+    beginPipeRead(&script->error.reader);
+    printf("[INFO] Started process: %s, PID: %lu\n", script->name, script->pi.dwProcessId);
+    return TRUE;
+}
+
+static void closeStream(HeadlessStream *stream)
+{
+    if (stream->reader.overlapped.hEvent)
+        closePipeReader(&stream->reader);
+    if (stream->pipe)
+        CloseHandle(stream->pipe);
+}
+
+// Prepend the launcher's Lib folder to PYTHONPATH, as Launcher.py does for every script.
+static void addLibToPythonPath(void)
+{
+    char libPath[MAX_PATH];
+    char current[4096];
+    char updated[4096 + MAX_PATH + 1];
+
+    if (!GetFullPathName(HEADLESS_LIB_PATH, sizeof(libPath), libPath, NULL))
+        return;
+
+    DWORD length = GetEnvironmentVariable("PYTHONPATH", current, sizeof(current));
+    if (length >= sizeof(current))
+        length = 0; // Too long to extend, keep it as it is
+    snprintf(updated, sizeof(updated), "%s;%s", libPath, length ? current : "");
+    SetEnvironmentVariable("PYTHONPATH", updated);
+}
+
+int runHeadless(const char *pythonPath, const char *groupPath, const LauncherConfig *config,
+                HANDLE shutdownEvent)
+{
+    printf("MSFS-PyScriptManager: Headless mode\n");
+    printf("-------------------------------------------------------------------------------------------\n\n");
+
+    HeadlessScript *scripts = (HeadlessScript *)calloc(HEADLESS_MAX_SCRIPTS, sizeof(HeadlessScript));
+    if (!scripts)
+    {
+        printf("[ERROR] Out of memory.\n");
+        return -1;
+    }
+
+    DWORD scriptCount = loadScriptGroup(groupPath, scripts, HEADLESS_MAX_SCRIPTS);
+    HeadlessOutput output = {0};
+    if (!scriptCount ||
+        !initConsoleWriter(&output.writer, config->outputRingSize, config->outputFlushBytes,
+                           config->outputFlushIntervalMs))
+    {
+        if (scriptCount)
+            printf("[ERROR] Failed to allocate the console output buffer.\n");
+        free(scripts);
+        return -1;
+    }
+
+    if (config->logFile[0])
+    {
+        output.logOpen = openRingLog(&output.log, config->logFile, config->logSizeMb * 1024 * 1024);
+        if (!output.logOpen)
+            printf("[WARNING] Failed to open log file %s. Error: %lu\n", config->logFile, GetLastError());
+    }
+
+    // One job for every script, with the same priority and affinity limits as the UI tree
+    HANDLE job = createProcessJob();
+    ProcessPolicy policy;
+    BOOL policyReady = FALSE;
+    if (job)
+    {
+        DWORD priorityClass = 0;
+        if (!parsePriorityClass(config->priorityClass, &priorityClass))
+            printf("[WARNING] Unknown priority class '%s', leaving the priority alone.\n", config->priorityClass);
+        policyReady = initProcessPolicy(&policy, job, priorityClass, (ULONG_PTR)config->affinityMask, config->ecoQos);
+    }
+    else
+    {
+        printf("[WARNING] Failed to create job object, scripts will not be supervised. Error: %lu\n",
+               GetLastError());
+    }
+
+    addLibToPythonPath();
+
+    DWORD running = 0;
+    for (DWORD i = 0; i < scriptCount; i++)
+    {
+        if (startHeadlessScript(&scripts[i], i, pythonPath, job, &output, config))
+            running++;
+    }
+    DWORD started = running;
+    if (!started)
+        printf("[ERROR] None of the scripts in the group could be started.\n");
+    if (policyReady)
+        applyProcessPolicy(&policy);
+
+    // Wait on every open pipe and running process until all are done
+    for (;;)
+    {
+        HANDLE waitHandles[1 + HEADLESS_MAX_SCRIPTS * 3];
+        HeadlessScript *waitScript[1 + HEADLESS_MAX_SCRIPTS * 3];
+        HeadlessStream *waitStream[1 + HEADLESS_MAX_SCRIPTS * 3];
+        DWORD handleCount = 0;
+        DWORD timeout = consoleWriterTimeout(&output.writer);
+
+        waitScript[handleCount] = NULL;
+        waitStream[handleCount] = NULL;
+        waitHandles[handleCount++] = shutdownEvent;
+
+        for (DWORD i = 0; i < scriptCount; i++)
+        {
+            HeadlessScript *script = &scripts[i];
+            HeadlessStream *streams[] = {&script->error, &script->output}; // stderr first
+            for (int s = 0; s < 2; s++)
+            {
+                DWORD summaryTimeout = coalescerTimeout(&streams[s]->coalescer);
+                if (summaryTimeout < timeout)
+                    timeout = summaryTimeout;
+                if (streams[s]->reader.pending)
+                {
+                    waitScript[handleCount] = script;
+                    waitStream[handleCount] = streams[s];
+                    waitHandles[handleCount++] = streams[s]->reader.overlapped.hEvent;
+                }
+            }
+            if (script->running)
+            {
+                waitScript[handleCount] = script;
+                waitStream[handleCount] = NULL;
+                waitHandles[handleCount++] = script->pi.hProcess;
+            }
+        }
+
+        // Only the shutdown event left: every script has exited and its pipes are drained
+        if (handleCount == 1)
+            break;
+
+        DWORD waitResult = WaitForMultipleObjects(handleCount, waitHandles, FALSE, timeout);
+        if (waitResult == WAIT_TIMEOUT)
+        {
+            // Summaries of repeated lines that are due, then the batched output
+            for (DWORD i = 0; i < scriptCount; i++)
+            {
+                coalescerFlushIfDue(&scripts[i].output.coalescer);
+                coalescerFlushIfDue(&scripts[i].error.coalescer);
+            }
+            consoleWriterFlush(&output.writer);
+            continue;
+        }
+        if (waitResult == WAIT_FAILED)
+        {
+            printf("[ERROR] Wait failed in headless loop. Error: %lu\n", GetLastError());
+            break;
+        }
+
+        DWORD index = waitResult - WAIT_OBJECT_0;
+        if (index == 0)
+        {
+            consoleWriterFlush(&output.writer);
+            printf("[INFO] Shutdown requested, stopping %lu scripts.\n", running);
+            if (job)
+                TerminateJobObject(job, 1);
+            break;
+        }
+
+        HeadlessScript *script = waitScript[index];
+        if (waitStream[index])
+        {
+            relayStream(waitStream[index]);
+        }
+        else
+        {
+            // Its remaining output is still relayed until the pipes break
+            DWORD exitCode = 0;
+            GetExitCodeProcess(script->pi.hProcess, &exitCode);
+            script->running = FALSE;
+            running--;
+            consoleWriterFlush(&output.writer);
+            printf("[INFO] %s exited with code %lu.\n", script->name, exitCode);
+        }
+    }
+
+    consoleWriterFlush(&output.writer);
+    for (DWORD i = 0; i < scriptCount; i++)
+    {
+        closeStream(&scripts[i].output);
+        closeStream(&scripts[i].error);
+        if (scripts[i].pi.hProcess)
+            CloseHandle(scripts[i].pi.hProcess);
+    }
+    if (job)
+        CloseHandle(job);
+    if (output.logOpen)
+        closeRingLog(&output.log);
+    closeConsoleWriter(&output.writer);
+    free(scripts);
+    return started ? 0 : -1;
+}
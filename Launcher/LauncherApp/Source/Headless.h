@@ -0,0 +1,23 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <windows.h>
+
+#include "Config.h"
+
+// Most scripts run by one headless launcher. Each needs three wait handles (stdout, stderr
+// and the process) within the 64 handle limit of WaitForMultipleObjects.
+#define HEADLESS_MAX_SCRIPTS 16
+
+// Longest line kept together before it is printed. Longer lines are split.
+#define HEADLESS_LINE_SIZE 4096
+
+// Run every script listed in a .script_group file (one path per line, relative to the file, as
+// written by Launcher.py's "Save Script Group") without starting Launcher.py. Each script gets
+// its own stdout/stderr pipes, and their output is printed to the console line by line with
+// the script name as prefix. Returns when every script has exited or shutdownEvent is set.
+// Returns 0, or -1 if no script could be started.
+int runHeadless(const char *pythonPath, const char *groupPath, const LauncherConfig *config,
+                HANDLE shutdownEvent);
+
+#endif // HEADLESS_H
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <string.h>
+#include "InterpreterPool.h"
+#include "JobObject.h"
+
+// Create an anonymous pipe whose child end is inheritable and whose parent end is not.
+static BOOL createChildPipe(HANDLE *childEnd, HANDLE *parentEnd, BOOL childReads)
+{
+    SECURITY_ATTRIBUTES sa = {sizeof(sa), NULL, TRUE};
+    HANDLE readEnd, writeEnd;
+
+    if (!CreatePipe(&readEnd, &writeEnd, &sa, 0))
+        return FALSE;
+
+    *childEnd = childReads ? readEnd : writeEnd;
+    *parentEnd = childReads ? writeEnd : readEnd;
+    SetHandleInformation(*parentEnd, HANDLE_FLAG_INHERIT, 0);
+    return TRUE;
+}
+
+// Move a launcher-side handle into the UI process. Returns the handle value there, or 0.
+static ULONGLONG giveHandleToUi(InterpreterPool *pool, HANDLE handle)
+{
+    HANDLE remote = NULL;
+    if (!DuplicateHandle(GetCurrentProcess(), handle, pool->uiProcess, &remote, 0, FALSE,
+                         DUPLICATE_SAME_ACCESS | DUPLICATE_CLOSE_SOURCE))
+        return 0;
+    return (ULONGLONG)(ULONG_PTR)remote;
+}
+
+// Close a handle that was already duplicated into the UI process.
+static void closeUiHandle(InterpreterPool *pool, ULONGLONG handle)
+{
+    if (handle)
+        DuplicateHandle(pool->uiProcess, (HANDLE)(ULONG_PTR)handle, NULL, NULL, 0, FALSE, DUPLICATE_CLOSE_SOURCE);
+}
+
+// Start one worker in the given slot and publish it as READY.
+static BOOL startWorker(InterpreterPool *pool, DWORD index)
+{
+    PoolSlot *slot = &pool->table->slots[index];
+    HANDLE childIn, childOut, childErr, parentIn, parentOut, parentErr;
+
+    if (!createChildPipe(&childIn, &parentIn, TRUE))
+        return FALSE;
+    if (!createChildPipe(&childOut, &parentOut, FALSE))
+    {
+        CloseHandle(childIn);
+        CloseHandle(parentIn);
+        return FALSE;
+    }
+    if (!createChildPipe(&childErr, &parentErr, FALSE))
+    {
+        CloseHandle(childIn);
+        CloseHandle(parentIn);
+        CloseHandle(childOut);
+        CloseHandle(parentOut);
+        return FALSE;
+    }
+
+    STARTUPINFO si = {sizeof(si), 0};
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = childIn;
+    si.hStdOutput = childOut;
+    si.hStdError = childErr;
+
+    PROCESS_INFORMATION pi = {0};
+    BOOL launched = createProcessInJob(pool->job, pool->commandLine, CREATE_NO_WINDOW, &si, &pi);
+
+    // Child ends now belong to the worker
+    CloseHandle(childIn);
+    CloseHandle(childOut);
+    CloseHandle(childErr);
+
+    if (!launched)
+    {
+        printf("[WARNING] Failed to start pool interpreter. Error: %lu\n", GetLastError());
+        CloseHandle(parentIn);
+        CloseHandle(parentOut);
+        CloseHandle(parentErr);
+        return FALSE;
+    }
+    CloseHandle(pi.hThread);
+
+    slot->pid = pi.dwProcessId;
+    slot->stdinHandle = giveHandleToUi(pool, parentIn);
+    slot->stdoutHandle = giveHandleToUi(pool, parentOut);
+    slot->stderrHandle = giveHandleToUi(pool, parentErr);
+
+    if (!slot->stdinHandle || !slot->stdoutHandle || !slot->stderrHandle)
+    {
+        printf("[WARNING] Failed to hand pool interpreter pipes to the UI. Error: %lu\n", GetLastError());
+        closeUiHandle(pool, slot->stdinHandle);
+        closeUiHandle(pool, slot->stdoutHandle);
+        closeUiHandle(pool, slot->stderrHandle);
+        TerminateProcess(pi.hProcess, 1);
+        CloseHandle(pi.hProcess);
+        return FALSE;
+    }
+
+    pool->workers[index] = pi.hProcess;
+    MemoryBarrier();
+    InterlockedExchange(&slot->state, POOL_SLOT_READY); // Publish after the handles
+    return TRUE;
+}
+
+// Prepare the pool and start the workers.
+BOOL initInterpreterPool(InterpreterPool *pool, PoolTable *table, const char *claimEventName,
+                         HANDLE job, HANDLE uiProcess, const char *pythonPath,
+                         const char *poolWorkerScript, const char *preload, DWORD workerCount)
+{
+    ZeroMemory(pool, sizeof(*pool));
+    pool->table = table;
+    pool->job = job;
+    pool->uiProcess = uiProcess;
+
+    if (workerCount > POOL_MAX_WORKERS)
+        workerCount = POOL_MAX_WORKERS;
+
+    int length = snprintf(pool->commandLine, sizeof(pool->commandLine), "\"%s\" -u \"%s\" --preload \"%s\"",
+                          pythonPath, poolWorkerScript, preload);
+    if (length < 0 || length >= (int)sizeof(pool->commandLine))
+        return FALSE;
+
+    if (GetFileAttributes(poolWorkerScript) == INVALID_FILE_ATTRIBUTES)
+    {
+        printf("[WARNING] Pool worker script not found: %s\n", poolWorkerScript);
+        return FALSE;
+    }
+
+    pool->claimEvent = CreateEvent(NULL, FALSE, FALSE, claimEventName);
+    if (!pool->claimEvent)
+        return FALSE;
+
+    strncpy(table->claimEventName, claimEventName, sizeof(table->claimEventName) - 1);
+    for (DWORD i = 0; i < workerCount; i++)
+        startWorker(pool, i);
+
+    table->workerCount = workerCount;  // Launcher.py only looks at slots below workerCount
+    printf("[INFO] Interpreter pool started with %lu workers\n", workerCount);
+    return TRUE;
+}
+
+// Replace workers that Launcher.py has claimed.
+void refillInterpreterPool(InterpreterPool *pool)
+{
+    for (DWORD i = 0; i < pool->table->workerCount; i++)
+    {
+        PoolSlot *slot = &pool->table->slots[i];
+        if (slot->state == POOL_SLOT_READY)
+            continue;
+
+        // The claimed worker now belongs to the UI (and its job); forget our handle to it
+        if (pool->workers[i])
+        {
+            CloseHandle(pool->workers[i]);
+            pool->workers[i] = NULL;
+        }
+        slot->state = POOL_SLOT_EMPTY;
+        startWorker(pool, i);
+    }
+}
+
+// Stop any unclaimed workers and release the pool's handles.
+void closeInterpreterPool(InterpreterPool *pool)
+{
+    if (pool->table)
+    {
+        for (DWORD i = 0; i < pool->table->workerCount; i++)
+        {
+            if (pool->workers[i])
+            {
+                if (pool->table->slots[i].state == POOL_SLOT_READY)
+                    TerminateProcess(pool->workers[i], 0);
+                CloseHandle(pool->workers[i]);
+                pool->workers[i] = NULL;
+            }
+        }
+        pool->table->workerCount = 0;
+    }
+    if (pool->claimEvent)
+    {
+        CloseHandle(pool->claimEvent);
+        pool->claimEvent = NULL;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef INTERPRETER_POOL_H
+#define INTERPRETER_POOL_H
+
+#include <windows.h>
+#include "Config.h"
+
+// Most pre-started interpreters the launcher keeps parked
+#define POOL_MAX_WORKERS 8
+
+// Slot states. The launcher moves EMPTY -> READY and CLAIMED -> EMPTY; Launcher.py only
+// moves READY -> CLAIMED, so no cross-process compare-and-swap is needed.
+#define POOL_SLOT_EMPTY   0
+#define POOL_SLOT_READY   1
+#define POOL_SLOT_CLAIMED 2
+
+// One parked worker. Handle values are valid inside the UI process (duplicated into it).
+// Mirrored in launcher_state.py.
+typedef struct
+{
+    volatile LONG state;   // POOL_SLOT_*
+    DWORD pid;             // Worker process ID
+    ULONGLONG stdinHandle; // Write end of the worker's stdin
+    ULONGLONG stdoutHandle;// Read end of the worker's stdout
+    ULONGLONG stderrHandle;// Read end of the worker's stderr
+} PoolSlot;
+
+// Pool table published in the shared state block
+typedef struct
+{
+    DWORD workerCount;          // Slots in use (0 when the pool is disabled)
+    DWORD reserved;
+    char claimEventName[64];    // Event Launcher.py sets after claiming a slot
+    PoolSlot slots[POOL_MAX_WORKERS];
+} PoolTable;
+
+// Launcher-side pool bookkeeping
+typedef struct
+{
+    PoolTable *table;        // Shared table
+    HANDLE job;              // Job the workers are created in
+    HANDLE uiProcess;        // Launcher.py process, receives the pipe handles
+    HANDLE claimEvent;       // Auto-reset event signalled by Launcher.py after a claim
+    char commandLine[CONFIG_STRING_SIZE * 2];
+    HANDLE workers[POOL_MAX_WORKERS]; // Process handles of unclaimed workers
+} InterpreterPool;
+
+// Prepare the pool and start workerCount interpreters running poolWorkerScript.
+// Returns FALSE if the pool could not be set up (scripts then start cold).
+BOOL initInterpreterPool(InterpreterPool *pool, PoolTable *table, const char *claimEventName,
+                         HANDLE job, HANDLE uiProcess, const char *pythonPath,
+                         const char *poolWorkerScript, const char *preload, DWORD workerCount);
+
+// Replace workers that Launcher.py has claimed. Called when the claim event is signalled.
+void refillInterpreterPool(InterpreterPool *pool);
+
+// Stop any unclaimed workers and release the pool's handles.
+void closeInterpreterPool(InterpreterPool *pool);
+
+#endif // INTERPRETER_POOL_H
@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <string.h>
+#include "Ipc.h"
+
+#define IPC_MAGIC_BYTE0 ((char)(IPC_FRAME_MAGIC & 0xFF))
+#define IPC_MAGIC_BYTE1 ((char)(IPC_FRAME_MAGIC >> 8))
+
+// Allocate the decoder buffer.
+BOOL initIpcDecoder(IpcDecoder *decoder)
+{
+    decoder->capacity = IPC_FRAME_HEADER_SIZE + IPC_MAX_PAYLOAD;
+    decoder->used = 0;
+    decoder->buffer = (char *)malloc(decoder->capacity);
+    return decoder->buffer != NULL;
+}
+
+// Read a little endian DWORD from an unaligned position.
+static DWORD readDword(const char *data)
+{
+    const BYTE *bytes = (const BYTE *)data;
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((DWORD)bytes[3] << 24);
+}
+
+// True if a valid frame header starts at data (at least IPC_FRAME_HEADER_SIZE bytes).
+static BOOL isFrameHeader(const char *data)
+{
+    BYTE channel = (BYTE)data[2];
+    return data[0] == IPC_MAGIC_BYTE0 && data[1] == IPC_MAGIC_BYTE1 &&
+           channel >= 1 && channel <= IPC_CHANNEL_MAX && data[3] == 0 &&
+           readDword(data + 4) <= IPC_MAX_PAYLOAD;
+}
+
+// Hand out every complete frame and raw run in the buffer; returns the bytes consumed.
+static DWORD decodeBuffered(IpcDecoder *decoder, IpcFrameHandler handler, void *context)
+{
+    const char *data = decoder->buffer;
+    DWORD used = decoder->used;
+    DWORD pos = 0;
+
+    while (pos < used)
+    {
+        DWORD available = used - pos;
+
+        if (data[pos] == IPC_MAGIC_BYTE0 && (available < 2 || data[pos + 1] == IPC_MAGIC_BYTE1))
+        {
+            // Possible frame: wait for the header, then for the payload
+            if (available < IPC_FRAME_HEADER_SIZE)
+                break;
+            if (isFrameHeader(data + pos))
+            {
+                DWORD length = readDword(data + pos + 4);
+                if (available < IPC_FRAME_HEADER_SIZE + length)
+                    break;
+                handler(context, (BYTE)data[pos + 2], data + pos + IPC_FRAME_HEADER_SIZE, length);
+                pos += IPC_FRAME_HEADER_SIZE + length;
+                continue;
+            }
+        }
+
+        // Unframed bytes run up to the next possible frame start
+        DWORD end = pos + 1;
+        while (end < used && data[end] != IPC_MAGIC_BYTE0)
+            end++;
+        handler(context, IPC_CHANNEL_LOG, data + pos, end - pos);
+        pos = end;
+    }
+    return pos;
+}
+
+// Decode as many frames as possible from data.
+void ipcDecoderFeed(IpcDecoder *decoder, const char *data, DWORD size, IpcFrameHandler handler, void *context)
+{
+    while (size > 0)
+    {
+        DWORD space = decoder->capacity - decoder->used;
+        DWORD chunk = size < space ? size : space;
+
+        memcpy(decoder->buffer + decoder->used, data, chunk);
+        decoder->used += chunk;
+        data += chunk;
+        size -= chunk;
+
+        // Keep only the incomplete tail for the next feed
+        DWORD consumed = decodeBuffered(decoder, handler, context);
+        decoder->used -= consumed;
+        if (consumed && decoder->used)
+            memmove(decoder->buffer, decoder->buffer + consumed, decoder->used);
+    }
+}
+
+// Release the decoder buffer.
+void closeIpcDecoder(IpcDecoder *decoder)
+{
+    free(decoder->buffer);
+    decoder->buffer = NULL;
+    decoder->used = 0;
+}
+
+// Build a frame in out.
+DWORD ipcEncodeFrame(BYTE channel, const void *payload, DWORD length, char *out, DWORD outSize)
+{
+    if (length > IPC_MAX_PAYLOAD || outSize < IPC_FRAME_HEADER_SIZE + length)
+        return 0;
+
+    out[0] = IPC_MAGIC_BYTE0;
+    out[1] = IPC_MAGIC_BYTE1;
+    out[2] = (char)channel;
+    out[3] = 0;
+    out[4] = (char)(length & 0xFF);
+    out[5] = (char)((length >> 8) & 0xFF);
+    out[6] = (char)((length >> 16) & 0xFF);
+    out[7] = (char)((length >> 24) & 0xFF);
+    memcpy(out + IPC_FRAME_HEADER_SIZE, payload, length);
+    return IPC_FRAME_HEADER_SIZE + length;
+}
@@ -0,0 +1,48 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include <windows.h>
+
+// Length-prefixed frames shared by the launcher and Launcher.py (launcher_ipc.py mirrors this).
+// Each frame is an 8 byte header followed by the payload:
+//   WORD magic, BYTE channel, BYTE flags (0), DWORD payload length (little endian)
+// The magic bytes are 0x1E 0xF5; 0xF5 never occurs in UTF-8, so raw text that bypasses the
+// framing (e.g. C-level writes to the inherited stdout) can be told apart and passed through
+// as log output.
+
+#define IPC_FRAME_MAGIC       0xF51E
+#define IPC_FRAME_HEADER_SIZE 8
+#define IPC_MAX_PAYLOAD       65536
+
+// Logical streams multiplexed over one pipe
+#define IPC_CHANNEL_LOG       1 // stdout text of Launcher.py (and raw unframed bytes)
+#define IPC_CHANNEL_STDERR    2 // stderr text of Launcher.py
+#define IPC_CHANNEL_TELEMETRY 3 // Reserved for telemetry records
+#define IPC_CHANNEL_CONTROL   4 // Commands such as "shutdown"
+#define IPC_CHANNEL_SPAWN     5 // Spawn service requests and script output (SpawnService.h)
+#define IPC_CHANNEL_MAX       IPC_CHANNEL_SPAWN
+
+// Called for every decoded frame and every run of unframed bytes (as IPC_CHANNEL_LOG)
+typedef void (*IpcFrameHandler)(void *context, BYTE channel, const char *payload, DWORD length);
+
+// Incremental decoder; partial frames are kept until the rest arrives
+typedef struct
+{
+    char *buffer;    // Holds at most one incomplete frame between feeds
+    DWORD capacity;  // Header plus the largest payload
+    DWORD used;      // Bytes currently buffered
+} IpcDecoder;
+
+// Allocate the decoder buffer. Returns FALSE on allocation failure.
+BOOL initIpcDecoder(IpcDecoder *decoder);
+
+// Decode as many frames as possible from data, calling handler for each.
+void ipcDecoderFeed(IpcDecoder *decoder, const char *data, DWORD size, IpcFrameHandler handler, void *context);
+
+// Release the decoder buffer.
+void closeIpcDecoder(IpcDecoder *decoder);
+
+// Build a frame in out. Returns the frame size, or 0 if it does not fit or is too large.
+DWORD ipcEncodeFrame(BYTE channel, const void *payload, DWORD length, char *out, DWORD outSize);
+
+#endif // IPC_H
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include "JobObject.h"
+
+// Create a job that kills every process in it when the last job handle is closed.
+HANDLE createProcessJob(void)
+{
+    HANDLE job = CreateJobObject(NULL, NULL);
+    if (!job)
+        return NULL;
+
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    ZeroMemory(&limits, sizeof(limits));
+    limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+
+    if (!SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits)))
+    {
+        CloseHandle(job);
+        return NULL;
+    }
+    return job;
+}
+
+// Create a process suspended, assign it to the job and then let it run.
+BOOL createProcessInJob(HANDLE job, char *commandLine, DWORD creationFlags, STARTUPINFO *si,
+                        PROCESS_INFORMATION *pi)
+{
+    return createProcessInJobEx(job, commandLine, creationFlags, NULL, NULL, si, pi);
+}
+
+// As createProcessInJob, with an environment block and working directory.
+BOOL createProcessInJobEx(HANDLE job, char *commandLine, DWORD creationFlags, void *environment,
+                          const char *currentDirectory, STARTUPINFO *si, PROCESS_INFORMATION *pi)
+{
+    if (!CreateProcess(NULL, commandLine, NULL, NULL, TRUE, creationFlags | CREATE_SUSPENDED,
+                       environment, currentDirectory, si, pi))
+        return FALSE;
+
+    if (!AssignProcessToJobObject(job, pi->hProcess))
+    {
+        // Not fatal - the process still runs, it just is not supervised by the job
+        printf("[WARNING] Failed to assign process to job object. Error: %lu\n", GetLastError());
+    }
+
+    ResumeThread(pi->hThread);
+    return TRUE;
+}
+
+// As createProcessInJobEx with wide strings.
+BOOL createProcessInJobW(HANDLE job, WCHAR *commandLine, DWORD creationFlags, void *environment,
+                         const WCHAR *currentDirectory, STARTUPINFOW *si, PROCESS_INFORMATION *pi)
+{
+    if (!CreateProcessW(NULL, commandLine, NULL, NULL, TRUE, creationFlags | CREATE_SUSPENDED,
+                        environment, currentDirectory, si, pi))
+        return FALSE;
+
+    if (!AssignProcessToJobObject(job, pi->hProcess))
+    {
+        // Not fatal - the process still runs, it just is not supervised by the job
+        printf("[WARNING] Failed to assign process to job object. Error: %lu\n", GetLastError());
+    }
+
+    ResumeThread(pi->hThread);
+    return TRUE;
+}
+
+// Read the accounting totals for the job.
+BOOL queryJobAccounting(HANDLE job, JobAccounting *accounting)
+{
+    JOBOBJECT_BASIC_AND_IO_ACCOUNTING_INFORMATION basic;
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION extended;
+
+    if (!QueryInformationJobObject(job, JobObjectBasicAndIoAccountingInformation, &basic, sizeof(basic), NULL) ||
+        !QueryInformationJobObject(job, JobObjectExtendedLimitInformation, &extended, sizeof(extended), NULL))
+        return FALSE;
+
+    accounting->userTime = basic.BasicInfo.TotalUserTime.QuadPart;
+    accounting->kernelTime = basic.BasicInfo.TotalKernelTime.QuadPart;
+    accounting->peakMemoryUsed = extended.PeakJobMemoryUsed;
+    accounting->ioReadBytes = basic.IoInfo.ReadTransferCount;
+    accounting->ioWriteBytes = basic.IoInfo.WriteTransferCount;
+    accounting->activeProcesses = basic.BasicInfo.ActiveProcesses;
+    accounting->totalProcesses = basic.BasicInfo.TotalProcesses;
+    accounting->terminatedProcesses = basic.BasicInfo.TotalTerminatedProcesses;
+    return TRUE;
+}
+
+// Print a one-line summary of the job's accounting totals.
+void printJobAccounting(const JobAccounting *accounting)
+{
+    printf("[INFO] Script job: %lu processes, CPU user %.1f s / kernel %.1f s, peak memory %.1f MB\n",
+           accounting->totalProcesses,
+           accounting->userTime / 1e7,
+           accounting->kernelTime / 1e7,
+           accounting->peakMemoryUsed / (1024.0 * 1024.0));
+}
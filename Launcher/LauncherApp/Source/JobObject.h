@@ -0,0 +1,45 @@
+#ifndef JOB_OBJECT_H
+#define JOB_OBJECT_H
+
+#include <windows.h>
+
+// Accounting totals for every process that has run in the job
+typedef struct
+{
+    ULONGLONG userTime;           // Total user-mode CPU time (100 ns units)
+    ULONGLONG kernelTime;         // Total kernel-mode CPU time (100 ns units)
+    ULONGLONG peakMemoryUsed;     // Peak committed memory of the whole job (bytes)
+    ULONGLONG ioReadBytes;        // Bytes read by all processes
+    ULONGLONG ioWriteBytes;       // Bytes written by all processes
+    DWORD activeProcesses;        // Processes currently in the job
+    DWORD totalProcesses;         // Processes ever assigned to the job
+    DWORD terminatedProcesses;    // Processes terminated because of a job limit
+} JobAccounting;
+
+// Create a job that kills every process in it when the last job handle is closed, so the
+// whole Python tree goes away with the launcher even if the launcher crashes.
+// Returns NULL on failure.
+HANDLE createProcessJob(void);
+
+// Create a process suspended, assign it to the job and then let it run, so that every child
+// it spawns is created inside the job. Same parameters as CreateProcess where they overlap.
+BOOL createProcessInJob(HANDLE job, char *commandLine, DWORD creationFlags, STARTUPINFO *si,
+                        PROCESS_INFORMATION *pi);
+
+// As createProcessInJob, with an environment block (NULL inherits the launcher's) and a
+// working directory (NULL uses the launcher's).
+BOOL createProcessInJobEx(HANDLE job, char *commandLine, DWORD creationFlags, void *environment,
+                          const char *currentDirectory, STARTUPINFO *si, PROCESS_INFORMATION *pi);
+
+// As createProcessInJobEx with wide strings. The environment is wide when creationFlags has
+// CREATE_UNICODE_ENVIRONMENT.
+BOOL createProcessInJobW(HANDLE job, WCHAR *commandLine, DWORD creationFlags, void *environment,
+                         const WCHAR *currentDirectory, STARTUPINFOW *si, PROCESS_INFORMATION *pi);
+
+// Read the accounting totals for the job. Returns FALSE if the query failed.
+BOOL queryJobAccounting(HANDLE job, JobAccounting *accounting);
+
+// Print a one-line summary of the job's accounting totals.
+void printJobAccounting(const JobAccounting *accounting);
+
+#endif // JOB_OBJECT_H
@@ -1,12 +1,43 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <windows.h>
 #include <time.h>
 
+#include "Config.h"
+#include "ConsoleWriter.h"
+#include "SharedState.h"
+#include "JobObject.h"
+#include "Telemetry.h"
+#include "InterpreterPool.h"
+#include "StartupProfile.h"
+#include "Ipc.h"
+#include "RingLog.h"
+#include "PostMortem.h"
+#include "ProcessPolicy.h"
+#include "PipeReader.h"
+#include "Headless.h"
+#include "SpawnService.h"
+#include "ShmRing.h"
+#include "Metrics.h"
+#include "CommandLine.h"
+#include "Preflight.h"
+#include "SingleInstance.h"
+
+// Interval between heartbeat increments in the shared state block
+#define HEARTBEAT_INTERVAL_MS 1000
+
 // Define types for function pointers to dynamically load Windows API functions.
 typedef HWND (*GetConsoleWindow_t)(void);
 typedef BOOL (*ShowWindow_t)(HWND, int);
 typedef BOOL (*SetForegroundWindow_t)(HWND);
+typedef BOOL (*AllowSetForegroundWindow_t)(DWORD);
+typedef LPWSTR *(WINAPI *CommandLineToArgvW_t)(LPCWSTR, int *);
+
+// AllowSetForegroundWindow argument allowing every process (newer than the TinyCC headers)
+#ifndef ASFW_ANY
+#define ASFW_ANY ((DWORD)-1)
+#endif
 
 // Load necessary functions from kernel32.dll and user32.dll to manage console window behavior.
 // Returns TRUE if all functions are successfully loaded, otherwise FALSE.
@@ -28,6 +59,52 @@ BOOL loadConsoleFunctions(GetConsoleWindow_t *getConsoleWindow, ShowWindow_t *sh
     return *getConsoleWindow && *showWindow && *setForegroundWindow;
 }
 
+// Console window and the functions used to move it, handed to the cosmetics thread
+typedef struct
+{
+    HWND console;
+    ShowWindow_t showWindow;
+    SetForegroundWindow_t setForegroundWindow;
+} ConsoleCosmetics;
+
+// Thread body: bring the console to the foreground, give the shell a moment to activate it,
+// then minimize it. Runs beside the launch so the pipe and process path never waits on it.
+DWORD WINAPI consoleCosmeticsThread(LPVOID parameter)
+{
+    ConsoleCosmetics *cosmetics = (ConsoleCosmetics *)parameter;
+
+    cosmetics->setForegroundWindow(cosmetics->console);
+    Sleep(100);
+    cosmetics->showWindow(cosmetics->console, SW_MINIMIZE);
+
+    free(cosmetics);
+    return 0;
+}
+
+// Foreground and minimize the console on a background thread. Falls back to doing it inline
+// (without the delay) if the thread cannot be started.
+void minimizeConsoleAsync(HWND hConsole, ShowWindow_t showWindow, SetForegroundWindow_t setForegroundWindow)
+{
+    ConsoleCosmetics *cosmetics = (ConsoleCosmetics *)malloc(sizeof(ConsoleCosmetics));
+    if (cosmetics)
+    {
+        cosmetics->console = hConsole;
+        cosmetics->showWindow = showWindow;
+        cosmetics->setForegroundWindow = setForegroundWindow;
+
+        HANDLE thread = CreateThread(NULL, 0, consoleCosmeticsThread, cosmetics, 0, NULL);
+        if (thread)
+        {
+            CloseHandle(thread);
+            return;
+        }
+        free(cosmetics);
+    }
+
+    setForegroundWindow(hConsole);
+    showWindow(hConsole, SW_MINIMIZE);
+}
+
 // Print an error message and restore the console window if it was minimized.
 void displayErrorAndRestoreConsole(const char *message, HWND hConsole, ShowWindow_t showWindow)
 {
@@ -39,72 +116,683 @@ void displayErrorAndRestoreConsole(const char *message, HWND hConsole, ShowWindo
 // Global handle for the shutdown pipe
 HANDLE g_hCommandPipe = NULL;
 
+// Shared state block read by Launcher.py (heartbeat counter and shutdown flag)
+SharedState *g_sharedState = NULL;
+
+// Start-up phase timestamps, only recorded with --profile-startup
+StartupProfile g_startupProfile;
+
+// Self-metrics of the launcher, reported to Launcher.py on a "stats" query
+LauncherMetrics g_metrics;
+
+// "group <path>" attach request for the script group given to this start, sent to Launcher.py
+// once it has connected; empty when there is none
+char g_openGroupRequest[ATTACH_REQUEST_SIZE];
+
+// Add the marks reported by Launcher.py and write the start-up trace. Until Launcher.py has
+// drawn its first frame this only writes when force is set (the launcher is exiting).
+void finishStartupProfile(SharedState *sharedState, const LauncherConfig *config, BOOL force)
+{
+    if (!g_startupProfile.enabled || g_startupProfile.written)
+        return;
+    if (!force && !sharedState->uiFirstFrameQpc)
+        return;
+
+    markStartupPhaseAt(&g_startupProfile, "ui_main", sharedState->uiMainQpc);
+    markStartupPhaseAt(&g_startupProfile, "ui_first_frame", sharedState->uiFirstFrameQpc);
+    writeStartupProfile(&g_startupProfile, config->startupProfilePath);
+}
+
+// CancelIoEx (kernel32, Vista and later), looked up at run time since the TinyCC headers lack it
+typedef BOOL (WINAPI *CancelIoExFn)(HANDLE, LPOVERLAPPED);
+
+// Cancel one overlapped operation and wait until it has stopped using the OVERLAPPED.
+static void cancelPipeIo(HANDLE pipe, OVERLAPPED *overlapped)
+{
+    static CancelIoExFn cancelIoEx = NULL;
+    static BOOL resolved = FALSE;
+    DWORD transferred = 0;
+
+    if (!resolved)
+    {
+        cancelIoEx = (CancelIoExFn)GetProcAddress(GetModuleHandle("kernel32.dll"), "CancelIoEx");
+        resolved = TRUE;
+    }
+    if (!cancelIoEx || !cancelIoEx(pipe, overlapped))
+        CancelIo(pipe); // The write was issued on this thread, so this cancels it too
+    GetOverlappedResult(pipe, overlapped, &transferred, TRUE);
+}
+
+// Write a whole buffer to a pipe opened with FILE_FLAG_OVERLAPPED, waiting up to timeoutMs
+// (INFINITE to wait for completion). A write that times out is cancelled and fails.
+BOOL writePipeOverlapped(HANDLE pipe, const void *data, DWORD size, DWORD timeoutMs)
+{
+    OVERLAPPED overlapped = {0};
+    DWORD bytesWritten = 0;
+    BOOL written;
+
+    overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!overlapped.hEvent)
+        return FALSE;
+
+    written = WriteFile(pipe, data, size, NULL, &overlapped);
+    if (!written && GetLastError() == ERROR_IO_PENDING)
+    {
+        if (WaitForSingleObject(overlapped.hEvent, timeoutMs) == WAIT_OBJECT_0)
+            written = TRUE;
+        else
+            cancelPipeIo(pipe, &overlapped);
+    }
+    if (written)
+        written = GetOverlappedResult(pipe, &overlapped, &bytesWritten, TRUE) && bytesWritten == size;
+
+    CloseHandle(overlapped.hEvent);
+    return written;
+}
+
+// Set by the console handler so the supervisor does not restart a UI the user is closing
+HANDLE g_shutdownEvent = NULL;
+
+// Handles the console handler needs for a bounded shutdown of the current run
+HANDLE g_hShutdownAck = NULL;   // Set by Launcher.py once it has finished shutting down
+HANDLE g_hPythonProcess = NULL; // Launcher.py process
+HANDLE g_hJob = NULL;           // Job holding Launcher.py and every script
+DWORD g_shutdownDeadlineMs = 3000;
+
+// Longest wait for a query reply to be written before it is dropped
+#define QUERY_REPLY_TIMEOUT_MS 100
+
+// TRUE when the command pipe carries IPC frames instead of newline terminated text
+BOOL g_commandFraming = FALSE;
+
+// Serializes writes to (and closing of) the command pipe, which the console handler and the
+// spawn service thread both write to
+CRITICAL_SECTION g_commandPipeLock;
+
+// Format one command (e.g. "shutdown") or query reply and write it to the command pipe.
+// The caller holds g_commandPipeLock and has checked g_hCommandPipe. Gives up after timeoutMs.
+BOOL writeLauncherCommand(const char *command, DWORD timeoutMs)
+{
+    char message[1024];
+    DWORD length = (DWORD)strlen(command);
+
+    if (g_commandFraming)
+    {
+        length = ipcEncodeFrame(IPC_CHANNEL_CONTROL, command, length, message, sizeof(message));
+        if (!length)
+            return FALSE;
+    }
+    else
+    {
+        if (length + 1 >= sizeof(message))
+            return FALSE;
+        memcpy(message, command, length);
+        message[length++] = '\n';
+    }
+    BOOL written = writePipeOverlapped(g_hCommandPipe, message, length, timeoutMs);
+    countCommandWrite(&g_metrics, written);
+    return written;
+}
+
+// Send one command to Launcher.py over the command pipe.
+BOOL sendLauncherCommand(const char *command)
+{
+    EnterCriticalSection(&g_commandPipeLock);
+    BOOL sent = g_hCommandPipe && writeLauncherCommand(command, INFINITE);
+    LeaveCriticalSection(&g_commandPipeLock);
+    return sent;
+}
+
+// SpawnSendFn: send a spawn service reply or script output as one frame on the command pipe.
+BOOL sendSpawnFrame(void *context, const char *payload, DWORD length)
+{
+    DWORD frameSize = length + IPC_FRAME_HEADER_SIZE;
+    char *frame = (char *)malloc(frameSize);
+    BOOL sent = FALSE;
+
+    if (frame && ipcEncodeFrame(IPC_CHANNEL_SPAWN, payload, length, frame, frameSize))
+    {
+        EnterCriticalSection(&g_commandPipeLock);
+        sent = g_hCommandPipe && writePipeOverlapped(g_hCommandPipe, frame, frameSize, INFINITE);
+        LeaveCriticalSection(&g_commandPipeLock);
+    }
+    free(frame);
+    countSpawnSend(&g_metrics, length, sent);
+    return sent;
+}
+
+// Longest wait for Launcher.py to make room in the spawn ring before a record is dropped
+#define SPAWN_RING_WRITE_TIMEOUT_MS 1000
+
+// SpawnSendFn: publish a spawn service reply or script output as one record in the spawn ring.
+BOOL sendSpawnRecord(void *context, const char *payload, DWORD length)
+{
+    ShmRing *ring = (ShmRing *)context;
+    BOOL written = shmRingWrite(ring, payload, length, SPAWN_RING_WRITE_TIMEOUT_MS);
+    countSpawnSend(&g_metrics, length, written);
+    if (written)
+        return TRUE;
+
+    // Warn on the 1st, 2nd, 4th, 8th... drop so a stalled UI does not flood the console
+    if ((ring->dropped & (ring->dropped - 1)) == 0)
+        printf("[WARNING] Launcher.py is not reading the spawn ring, %lu records dropped.\n", ring->dropped);
+    return FALSE;
+}
+
 // Console control handler to send a shutdown signal to the Python script.
 BOOL WINAPI ConsoleHandler(DWORD dwCtrlType)
 {
     if (dwCtrlType == CTRL_CLOSE_EVENT || dwCtrlType == CTRL_C_EVENT || dwCtrlType == CTRL_SHUTDOWN_EVENT)
     {
-        if (g_hCommandPipe)
+        if (g_shutdownEvent)
+            SetEvent(g_shutdownEvent);
+
+        // The flag is what Launcher.py checks; the pipe message remains for older scripts
+        if (g_sharedState)
+            InterlockedExchange(&g_sharedState->shutdownRequested, 1);
+
+        // Skipped if the spawn service is stuck writing to a hung Launcher.py, and bounded by the
+        // deadline otherwise. A write that used up the deadline leaves nothing to wait for below,
+        // so a Launcher.py that stopped reading is killed straight away
+        DWORD startTick = GetTickCount();
+        if (TryEnterCriticalSection(&g_commandPipeLock))
+        {
+            if (g_hCommandPipe)
+            {
+                writeLauncherCommand("shutdown", g_shutdownDeadlineMs);
+                CloseHandle(g_hCommandPipe);
+                g_hCommandPipe = NULL;
+            }
+            LeaveCriticalSection(&g_commandPipeLock);
+        }
+
+        // Windows ends the process about 5 s after a close event, so wait only up to the
+        // deadline for Launcher.py to acknowledge, then kill the whole tree outright
+        HANDLE ack = g_hShutdownAck;
+        HANDLE process = g_hPythonProcess;
+        HANDLE job = g_hJob;
+        if (ack && process)
         {
-            const char *shutdownMessage = "shutdown\n";
-            DWORD bytesWritten;
-            WriteFile(g_hCommandPipe, shutdownMessage, strlen(shutdownMessage), &bytesWritten, NULL);
-            CloseHandle(g_hCommandPipe);
-            g_hCommandPipe = NULL;
+            HANDLE waitHandles[] = {ack, process};
+            DWORD elapsed = GetTickCount() - startTick;
+            DWORD remaining = elapsed < g_shutdownDeadlineMs ? g_shutdownDeadlineMs - elapsed : 0;
+            DWORD waitResult = WaitForMultipleObjects(2, waitHandles, FALSE, remaining);
+            if (waitResult == WAIT_TIMEOUT && job)
+            {
+                printf("[WARNING] Launcher.py did not finish shutting down within %lu ms, terminating.\n",
+                       g_shutdownDeadlineMs);
+                TerminateJobObject(job, 1);
+            }
         }
         return TRUE; // Prevent further handling
     }
     return FALSE;
 }
 
-// Processes data from the inbound pipe, sends periodic heartbeats, and monitors the
-// Python process.
-void processPipeDataLoop(HANDLE hInboundPipe, HANDLE hCommandPipe, PROCESS_INFORMATION *pi)
+// Where relayed pipe output goes: the console and, if configured, the rolling log file
+typedef struct
 {
-    char buffer[4096];
-    DWORD bytesRead;
-    DWORD lastHeartbeatTime = GetTickCount(); // Track the last time a heartbeat was sent
-    const DWORD heartbeatInterval = 1000;    // Send heartbeat every 1 second
-    const char *heartbeatMessage = "HEARTBEAT\n";
+    ConsoleWriter *writer;
+    RingLog *log;           // NULL when no log file is configured
+    SpawnService *spawnService; // Receives spawn requests, NULL when the service is off
+} OutputSink;
 
-    while (1)
+// Pass output to the console writer and tee it into the log file.
+void sinkAppend(OutputSink *sink, const char *data, DWORD length)
+{
+    if (sink->log)
+        ringLogWrite(sink->log, data, length);
+    consoleWriterAppend(sink->writer, data, length);
+}
+
+// Answer a query Launcher.py sent as a control frame. The reply goes back on the command
+// pipe as a control frame starting with the query's name. This runs on the pipe loop, so the
+// reply is dropped rather than stalling output relay when the pipe is busy or Launcher.py is
+// not reading it; Launcher.py asks again on its next poll.
+void answerLauncherQuery(const char *query, DWORD length)
+{
+    char reply[1024 - IPC_FRAME_HEADER_SIZE];
+
+    if (length == 5 && memcmp(query, "stats", 5) == 0)
+    {
+        strcpy(reply, "stats\n");
+        if (!formatLauncherMetrics(&g_metrics, reply + 6, sizeof(reply) - 6))
+            return;
+
+        // The spawn service may hold the lock for a blocking write; skip the reply then too
+        if (!TryEnterCriticalSection(&g_commandPipeLock))
+            return;
+        if (g_hCommandPipe)
+            writeLauncherCommand(reply, QUERY_REPLY_TIMEOUT_MS);
+        LeaveCriticalSection(&g_commandPipeLock);
+    }
+}
+
+// Frame handler for the output pipes: text channels go to the sink, spawn requests to the
+// spawn service and queries are answered; the rest is not produced by Launcher.py yet and is
+// dropped.
+void relayFrame(void *context, BYTE channel, const char *payload, DWORD length)
+{
+    OutputSink *sink = (OutputSink *)context;
+    if (channel == IPC_CHANNEL_LOG || channel == IPC_CHANNEL_STDERR)
+        sinkAppend(sink, payload, length);
+    else if (channel == IPC_CHANNEL_SPAWN && sink->spawnService)
+        spawnServiceRequest(sink->spawnService, payload, length);
+    else if (channel == IPC_CHANNEL_CONTROL)
+        answerLauncherQuery(payload, length);
+}
+
+// Pass a completed read to the sink, through the frame decoder when the output is framed.
+// Returns the bytes read.
+DWORD relayReadData(PipeReader *reader, OutputSink *sink, IpcDecoder *decoder)
+{
+    DWORD bytesRead = completePipeRead(reader);
+    if (decoder)
+        ipcDecoderFeed(decoder, reader->buffer, bytesRead, relayFrame, sink);
+    else
+        sinkAppend(sink, reader->buffer, bytesRead);
+    return bytesRead;
+}
+
+// Hand a completed read to the console writer (through the frame decoder when the output is
+// framed) and queue the next read. Pending output is flushed once the pipe has been drained,
+// so batching only happens while data keeps coming.
+void relayPipeData(PipeReader *reader, OutputSink *sink, IpcDecoder *decoder)
+{
+    g_metrics.stdoutReads++;
+    g_metrics.stdoutBytes += relayReadData(reader, sink, decoder);
+    beginPipeRead(reader);
+
+    if (!reader->pending || WaitForSingleObject(reader->overlapped.hEvent, 0) != WAIT_OBJECT_0)
+        consoleWriterFlush(sink->writer);
+    else
+        consoleWriterFlushIfDue(sink->writer);
+}
+
+// Relay a completed stderr read and flush straight away, so errors never wait behind batched
+// stdout output.
+void relayErrorData(PipeReader *reader, OutputSink *sink, IpcDecoder *decoder)
+{
+    g_metrics.stderrReads++;
+    g_metrics.stderrBytes += relayReadData(reader, sink, decoder);
+    beginPipeRead(reader);
+    consoleWriterFlush(sink->writer);
+}
+
+// Relay every stderr read that has already completed.
+void drainErrorPipe(PipeReader *reader, OutputSink *sink, IpcDecoder *decoder)
+{
+    while (reader->pending && WaitForSingleObject(reader->overlapped.hEvent, 0) == WAIT_OBJECT_0)
+        relayErrorData(reader, sink, decoder);
+}
+
+// Most pipes connected together by connectPipesOverlapped
+#define MAX_CONNECT_PIPES 4
+
+// Connect the server ends of several overlapped named pipes at once. All connects are issued
+// up front and waited on together with the client process, so a client that exits before
+// opening its pipes fails the connect instead of hanging it.  timeoutMs of 0 waits forever.
+// Returns TRUE once every pipe is connected; otherwise outstanding connects are cancelled.
+BOOL connectPipesOverlapped(HANDLE *pipes, DWORD count, HANDLE client, DWORD timeoutMs)
+{
+    OVERLAPPED overlapped[MAX_CONNECT_PIPES] = {0};
+    BOOL pending[MAX_CONNECT_PIPES] = {0};
+    DWORD remaining = 0;
+    BOOL failed = FALSE;
+    DWORD ignored;
+
+    if (count > MAX_CONNECT_PIPES)
+        return FALSE;
+
+    // Issue every connect before waiting on any of them
+    for (DWORD i = 0; i < count && !failed; i++)
+    {
+        overlapped[i].hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+        if (!overlapped[i].hEvent)
+        {
+            failed = TRUE;
+            break;
+        }
+
+        if (!ConnectNamedPipe(pipes[i], &overlapped[i]))
+        {
+            DWORD error = GetLastError();
+            if (error == ERROR_IO_PENDING)
+            {
+                pending[i] = TRUE;
+                remaining++;
+            }
+            else if (error != ERROR_PIPE_CONNECTED)
+            {
+                printf("[ERROR] Failed to start pipe connect. Error: %lu\n", error);
+                failed = TRUE;
+            }
+        }
+    }
+
+    DWORD startTick = GetTickCount();
+    while (!failed && remaining > 0)
     {
-        // Check if data is available in the pipe
-        DWORD bytesAvailable = 0;
-        BOOL hasData = PeekNamedPipe(hInboundPipe, NULL, 0, NULL, &bytesAvailable, NULL);
+        HANDLE waitHandles[MAX_CONNECT_PIPES + 1];
+        DWORD waitPipe[MAX_CONNECT_PIPES];
+        DWORD handleCount = 0;
 
-        if (hasData && bytesAvailable > 0)
+        for (DWORD i = 0; i < count; i++)
         {
-            // Read the available data
-            BOOL result = ReadFile(hInboundPipe, buffer, sizeof(buffer) - 1, &bytesRead, NULL);
-            if (result && bytesRead > 0)
+            if (pending[i])
             {
-                buffer[bytesRead] = '\0'; // Null-terminate the string
-                printf("%s", buffer);    // Display the script's output
+                waitPipe[handleCount] = i;
+                waitHandles[handleCount++] = overlapped[i].hEvent;
             }
         }
+        DWORD clientIndex = handleCount;
+        waitHandles[handleCount++] = client;
 
-        // Send a heartbeat command periodically
-        DWORD currentTime = GetTickCount();
-        if (currentTime - lastHeartbeatTime >= heartbeatInterval)
+        DWORD timeout = INFINITE;
+        if (timeoutMs > 0)
+        {
+            DWORD elapsed = GetTickCount() - startTick;
+            timeout = elapsed >= timeoutMs ? 0 : timeoutMs - elapsed;
+        }
+
+        DWORD waitResult = WaitForMultipleObjects(handleCount, waitHandles, FALSE, timeout);
+        if (waitResult == WAIT_TIMEOUT)
+        {
+            printf("[ERROR] Timed out after %lu ms waiting for Launcher.py to connect.\n", timeoutMs);
+            failed = TRUE;
+        }
+        else if (waitResult == WAIT_FAILED)
         {
-            DWORD bytesWritten;
-            if (!WriteFile(g_hCommandPipe, heartbeatMessage, strlen(heartbeatMessage), &bytesWritten, NULL))
+            printf("[ERROR] Wait failed while connecting pipes. Error: %lu\n", GetLastError());
+            failed = TRUE;
+        }
+        else if (waitResult - WAIT_OBJECT_0 == clientIndex)
+        {
+            printf("[ERROR] Launcher.py exited before connecting to the launcher.\n");
+            failed = TRUE;
+        }
+        else
+        {
+            DWORD i = waitPipe[waitResult - WAIT_OBJECT_0];
+            pending[i] = FALSE;
+            remaining--;
+            if (!GetOverlappedResult(pipes[i], &overlapped[i], &ignored, FALSE))
             {
-                printf("[ERROR] Failed to send heartbeat. Error: %lu\n", GetLastError());
+                printf("[ERROR] Pipe connect failed. Error: %lu\n", GetLastError());
+                failed = TRUE;
             }
-            lastHeartbeatTime = currentTime;
         }
+    }
 
-        // Check if the Python process has exited
-        if (WaitForSingleObject(pi->hProcess, 0) == WAIT_OBJECT_0)
+    for (DWORD i = 0; i < count; i++)
+    {
+        if (pending[i])
         {
+            CancelIo(pipes[i]);
+            GetOverlappedResult(pipes[i], &overlapped[i], &ignored, TRUE); // Wait for the cancel
+        }
+        if (overlapped[i].hEvent)
+            CloseHandle(overlapped[i].hEvent);
+    }
+    return !failed;
+}
+
+// Relay Launcher.py's stdout and stderr until it exits. Blocks in one WaitForMultipleObjects
+// on the pipe reads, the process handle and a heartbeat timer, so it uses no CPU while idle.
+// stderr is waited on first and flushed at once so tracebacks never queue behind stdout,
+// which is batched through a ConsoleWriter. Each timer tick advances the heartbeat and does
+// the periodic work (telemetry, job accounting, pool refills).
+void processPipeDataLoop(HANDLE hInboundPipe, HANDLE hErrorPipe, SharedState *sharedState, HANDLE hJob,
+                         PROCESS_INFORMATION *pi, InterpreterPool *pool, ProcessPolicy *policy,
+                         SpawnService *spawnService, const LauncherConfig *config)
+{
+    const LONG heartbeatInterval = HEARTBEAT_INTERVAL_MS;
+
+    PipeReader reader;
+    PipeReader errorReader;
+    BOOL readersReady = initPipeReader(&reader, hInboundPipe, config->readBufferSize);
+    readersReady = initPipeReader(&errorReader, hErrorPipe, config->readBufferSize) && readersReady;
+    if (!readersReady)
+    {
+        printf("[ERROR] Failed to create pipe reader. Error: %lu\n", GetLastError());
+        closePipeReader(&reader);
+        closePipeReader(&errorReader);
+        return;
+    }
+
+    ConsoleWriter writer;
+    if (!initConsoleWriter(&writer, config->outputRingSize, config->outputFlushBytes,
+                           config->outputFlushIntervalMs))
+    {
+        printf("[ERROR] Failed to allocate console output buffer.\n");
+        closePipeReader(&reader);
+        closePipeReader(&errorReader);
+        return;
+    }
+
+    // Periodic waitable timer for the heartbeat, first due one interval from now
+    HANDLE hHeartbeatTimer = CreateWaitableTimer(NULL, FALSE, NULL);
+    LARGE_INTEGER dueTime;
+    dueTime.QuadPart = -10000LL * heartbeatInterval; // Relative time in 100 ns units
+    if (!hHeartbeatTimer || !SetWaitableTimer(hHeartbeatTimer, &dueTime, heartbeatInterval, NULL, NULL, FALSE))
+    {
+        printf("[ERROR] Failed to create heartbeat timer. Error: %lu\n", GetLastError());
+        closePipeReader(&reader);
+        closePipeReader(&errorReader);
+        closeConsoleWriter(&writer);
+        if (hHeartbeatTimer)
+            CloseHandle(hHeartbeatTimer);
+        return;
+    }
+
+    // Optional telemetry timer, sampling every process in the job at the configured rate
+    TelemetrySampler sampler;
+    HANDLE hTelemetryTimer = NULL;
+    if (hJob && config->telemetryIntervalMs > 0)
+    {
+        initTelemetrySampler(&sampler, hJob, config->telemetryIntervalMs);
+        hTelemetryTimer = CreateWaitableTimer(NULL, FALSE, NULL);
+        dueTime.QuadPart = -10000LL * config->telemetryIntervalMs;
+        if (hTelemetryTimer &&
+            !SetWaitableTimer(hTelemetryTimer, &dueTime, config->telemetryIntervalMs, NULL, NULL, FALSE))
+        {
+            CloseHandle(hTelemetryTimer);
+            hTelemetryTimer = NULL;
+        }
+        if (!hTelemetryTimer)
+            printf("[WARNING] Failed to create telemetry timer. Error: %lu\n", GetLastError());
+    }
+
+    // Launcher.py frames its stdout and stderr when framing is enabled (one decoder per pipe)
+    IpcDecoder ipcDecoder = {0};
+    IpcDecoder ipcErrorDecoder = {0};
+    IpcDecoder *decoder = NULL;
+    IpcDecoder *errorDecoder = NULL;
+    if (config->ipcFraming)
+    {
+        if (initIpcDecoder(&ipcDecoder) && initIpcDecoder(&ipcErrorDecoder))
+        {
+            decoder = &ipcDecoder;
+            errorDecoder = &ipcErrorDecoder;
+        }
+        else
+            printf("[WARNING] Failed to allocate frame decoder, output is shown undecoded.\n");
+    }
+
+    // Optional tee of everything relayed into the memory-mapped rolling log
+    RingLog ringLog = {0};
+    OutputSink sink = {&writer, NULL, spawnService};
+    if (config->logFile[0])
+    {
+        if (openRingLog(&ringLog, config->logFile, config->logSizeMb * 1024 * 1024))
+            sink.log = &ringLog;
+        else
+            printf("[WARNING] Failed to open log file %s. Error: %lu\n", config->logFile, GetLastError());
+    }
+
+    // Post-mortem capture: minidump when the UI heartbeat stalls, output tail when Python crashes
+    PostMortem postMortem;
+    BOOL postMortemReady = config->postMortem &&
+        initPostMortem(&postMortem, config->postMortemDirectory, config->postMortemTailKb * 1024);
+    LONG lastUiHeartbeat = sharedState->uiHeartbeat;
+    DWORD lastUiHeartbeatTick = GetTickCount();
+    BOOL hangCaptured = FALSE;
+
+    beginPipeRead(&errorReader);
+    beginPipeRead(&reader);
+    BOOL firstOutputSeen = FALSE;
+
+    while (1)
+    {
+        // Once the pipe is closed only the process and the timers are waited on
+        HANDLE waitHandles[6];
+        DWORD handleCount = 0;
+        DWORD pipeIndex = MAXDWORD;
+        DWORD errorPipeIndex = MAXDWORD;
+
+        // stderr goes first: WaitForMultipleObjects reports the lowest signalled index
+        if (!errorReader.closed)
+        {
+            errorPipeIndex = handleCount;
+            waitHandles[handleCount++] = errorReader.overlapped.hEvent;
+        }
+        if (!reader.closed)
+        {
+            pipeIndex = handleCount;
+            waitHandles[handleCount++] = reader.overlapped.hEvent;
+        }
+        DWORD processIndex = handleCount;
+        waitHandles[handleCount++] = pi->hProcess;
+        DWORD timerIndex = handleCount;
+        waitHandles[handleCount++] = hHeartbeatTimer;
+        DWORD telemetryIndex = MAXDWORD;
+        if (hTelemetryTimer)
+        {
+            telemetryIndex = handleCount;
+            waitHandles[handleCount++] = hTelemetryTimer;
+        }
+        DWORD poolIndex = MAXDWORD;
+        if (pool && pool->claimEvent)
+        {
+            poolIndex = handleCount;
+            waitHandles[handleCount++] = pool->claimEvent;
+        }
+
+        // Wake up early if batched output is due to be flushed
+        DWORD waitResult = WaitForMultipleObjects(handleCount, waitHandles, FALSE,
+                                                  consoleWriterTimeout(&writer));
+        LONGLONG wakeupStart = beginLoopWakeup();
+        if (waitResult == WAIT_TIMEOUT)
+        {
+            consoleWriterFlush(&writer);
+            g_metrics.flushTimeouts++;
+            endLoopWakeup(&g_metrics, wakeupStart);
+            continue;
+        }
+        if (waitResult == WAIT_FAILED)
+        {
+            consoleWriterFlush(&writer);
+            printf("[ERROR] Wait failed in pipe loop. Error: %lu\n", GetLastError());
+            break;
+        }
+
+        DWORD index = waitResult - WAIT_OBJECT_0;
+        if (index == errorPipeIndex)
+        {
+            relayErrorData(&errorReader, &sink, errorDecoder);
+        }
+        else if (index == pipeIndex)
+        {
+            // Relay the completed read and immediately queue the next one
+            relayPipeData(&reader, &sink, decoder);
+            if (!firstOutputSeen && writer.writePos > 0)
+            {
+                firstOutputSeen = TRUE;
+                markStartupPhase(&g_startupProfile, "first_output_byte");
+            }
+        }
+        else if (index == timerIndex)
+        {
+            // Advance the heartbeat, Launcher.py treats a stalled counter as a dead launcher
+            InterlockedIncrement(&sharedState->heartbeat);
+            g_metrics.timerTicks++;
+
+            // Refresh the job totals shown by Launcher.py
+            JobAccounting accounting;
+            if (hJob && queryJobAccounting(hJob, &accounting))
+                publishJobAccounting(sharedState, &accounting);
+
+            finishStartupProfile(sharedState, config, FALSE);
+
+            // EcoQoS is per process, pick up scripts started since the last tick
+            if (policy)
+                applyProcessPolicy(policy);
+
+            // Launcher.py beats from its Tk loop once it is up; one dump per hang
+            if (postMortemReady && config->hangSeconds > 0)
+            {
+                LONG uiHeartbeat = sharedState->uiHeartbeat;
+                if (uiHeartbeat != lastUiHeartbeat)
+                {
+                    lastUiHeartbeat = uiHeartbeat;
+                    lastUiHeartbeatTick = GetTickCount();
+                    hangCaptured = FALSE;
+                }
+                else if (uiHeartbeat != 0 && !hangCaptured &&
+                         GetTickCount() - lastUiHeartbeatTick >= config->hangSeconds * 1000)
+                {
+                    printf("[WARNING] Launcher.py has not responded for %lu seconds, capturing a minidump.\n",
+                           config->hangSeconds);
+                    capturePostMortemDump(&postMortem, pi->hProcess, pi->dwProcessId, "hang", &writer);
+                    hangCaptured = TRUE;
+                }
+            }
+        }
+        else if (index == telemetryIndex)
+        {
+            sampleTelemetry(&sampler, &sharedState->telemetry);
+        }
+        else if (index == poolIndex)
+        {
+            // Launcher.py took a worker, start its replacement so the next script also starts warm
+            refillInterpreterPool(pool);
+        }
+        else if (index == processIndex)
+        {
+            // Drain whatever output is already sitting in the pipes before leaving, errors first
+            drainErrorPipe(&errorReader, &sink, errorDecoder);
+            while (reader.pending && WaitForSingleObject(reader.overlapped.hEvent, 0) == WAIT_OBJECT_0)
+            {
+                relayPipeData(&reader, &sink, decoder);
+            }
+
+            consoleWriterFlush(&writer);
             printf("[INFO] Python process has exited.\n");
+
+            DWORD exitCode = 0;
+            if (postMortemReady && GetExitCodeProcess(pi->hProcess, &exitCode) && exitCode != 0)
+                capturePostMortemTail(&postMortem, pi->dwProcessId, "crash", exitCode, &writer);
             break;
         }
+        endLoopWakeup(&g_metrics, wakeupStart);
+    }
 
-        Sleep(10);
+    CancelWaitableTimer(hHeartbeatTimer);
+    CloseHandle(hHeartbeatTimer);
+    if (hTelemetryTimer)
+    {
+        CancelWaitableTimer(hTelemetryTimer);
+        CloseHandle(hTelemetryTimer);
     }
+    closePipeReader(&reader);
+    closePipeReader(&errorReader);
+    closeConsoleWriter(&writer);
+    closeIpcDecoder(&ipcDecoder);
+    closeIpcDecoder(&ipcErrorDecoder);
+    if (sink.log)
+        closeRingLog(&ringLog);
+    if (postMortemReady)
+        closePostMortem(&postMortem);
 }
 
 // Creates a named pipe with a unique name and specified access mode.
@@ -113,6 +801,8 @@ HANDLE createNamedPipe(
     DWORD pid,                      // Process ID to include in the pipe name for uniqueness
     int randomSuffix,               // Random number to further ensure uniqueness of the pipe name
     DWORD accessMode,               // Access mode (e.g., PIPE_ACCESS_INBOUND or PIPE_ACCESS_OUTBOUND)
+    DWORD pipeMode,                 // Pipe mode (e.g., PIPE_TYPE_BYTE or PIPE_TYPE_MESSAGE)
+    DWORD bufferSize,               // Kernel buffer size for each direction
     char *pipeNameBuffer,           // Buffer to store the generated pipe name
     size_t pipeNameBufferSize,      // Size of the pipeNameBuffer
     SECURITY_ATTRIBUTES *sa,        // Pointer to SECURITY_ATTRIBUTES for the pipe
@@ -125,10 +815,10 @@ HANDLE createNamedPipe(
     HANDLE pipeHandle = CreateNamedPipe(
         pipeNameBuffer,           // Pipe name
         accessMode,               // Access mode (e.g., read-only or write-only)
-        PIPE_TYPE_BYTE | PIPE_WAIT, // Byte stream pipe, blocking mode
+        pipeMode | PIPE_WAIT,     // Byte or message pipe, blocking mode
         1,                        // Max instances
-        4096,                     // Output buffer size
-        4096,                     // Input buffer size
+        bufferSize,               // Output buffer size
+        bufferSize,               // Input buffer size
         0,                        // Default timeout
         sa                        // Security attributes
     );
@@ -145,11 +835,8 @@ HANDLE createNamedPipe(
 
 // Execute a Python script using the specified interpreter path and script file path
 // Returns the exit code from the Python process, or -1 if there was an error
-int run_script(const char *pythonPath, const char *scriptPath)
+int run_script(const char *pythonPath, const char *scriptPath, const LauncherConfig *config)
 {
-    char commandLine[512];
-    snprintf(commandLine, sizeof(commandLine), "\"%s\" -u \"%s\"", pythonPath, scriptPath);
-
     printf("MSFS-PyScriptManager: Loader exe\n");
     printf("-------------------------------------------------------------------------------------------\n\n");
 
@@ -172,9 +859,6 @@ int run_script(const char *pythonPath, const char *scriptPath)
         return -1;
     }
 
-    // Minimize the console window
-    Sleep(100); // Allow time for the operation to take effect
-
     // Declare and initialize SECURITY_ATTRIBUTES
     SECURITY_ATTRIBUTES sa = {0};
     sa.nLength = sizeof(sa);
@@ -183,19 +867,41 @@ int run_script(const char *pythonPath, const char *scriptPath)
 
     // Generate a unique pipe name using process ID and timestamp
     DWORD pid = GetCurrentProcessId();
-    srand((unsigned int)time(NULL)); // Seed the random number generator
-    int randomSuffix = rand();       // Generate a random number
+    int randomSuffix = rand();       // Generate a random number (seeded once in main)
 
     // Buffers to store pipe names
     char scriptOutputPipeName[256];
+    char scriptErrorPipeName[256];
     char scriptCommandPipeName[256];
+    char sharedStateName[256];
+
+    // Create the shared state block (heartbeat and shutdown flag) before anything can fail
+    HANDLE hSharedState = NULL;
+    g_sharedState = createSharedState(pid, randomSuffix, HEARTBEAT_INTERVAL_MS,
+                                      sharedStateName, sizeof(sharedStateName), &hSharedState);
+    if (!g_sharedState)
+    {
+        displayErrorAndRestoreConsole("Failed to create shared state block.", hConsole, showWindow);
+        return -1;
+    }
+    markStartupPhase(&g_startupProfile, "shared_state_created");
+
+    // Launcher.py sets this event when its shutdown is complete
+    snprintf(g_sharedState->shutdownAckEventName, sizeof(g_sharedState->shutdownAckEventName),
+             "Local\\MSFSPyScriptManagerShutdownAck_%lu_%d", pid, randomSuffix);
+    g_shutdownDeadlineMs = config->shutdownDeadlineMs;
+    g_hShutdownAck = CreateEvent(NULL, TRUE, FALSE, g_sharedState->shutdownAckEventName);
+    if (!g_hShutdownAck)
+        printf("[WARNING] Failed to create shutdown acknowledgement event. Error: %lu\n", GetLastError());
 
     // Create the stdout inbound pipe
     HANDLE hInboundPipe = createNamedPipe(
         "PythonOutputPipe",        // Pipe prefix
         pid,                       // Process ID
         randomSuffix,              // Random suffix
-        PIPE_ACCESS_INBOUND,       // Read-only access
+        PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED, // Read-only access, overlapped reads
+        PIPE_TYPE_BYTE,            // Script output is a byte stream
+        config->outputPipeBufferSize,
         scriptOutputPipeName,      // Output: pipe name
         sizeof(scriptOutputPipeName),
         &sa,                       // Pass SECURITY_ATTRIBUTES
@@ -208,12 +914,41 @@ int run_script(const char *pythonPath, const char *scriptPath)
         return -1; // Exit if the pipe couldn't be created
     }
 
+    // Create the stderr inbound pipe, kept apart from stdout so errors can be relayed first
+    HANDLE hErrorPipe = createNamedPipe(
+        "PythonErrorPipe",         // Pipe prefix
+        pid,                       // Process ID
+        randomSuffix,              // Random suffix
+        PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED, // Read-only access, overlapped reads
+        PIPE_TYPE_BYTE,            // Error output is a byte stream
+        config->outputPipeBufferSize,
+        scriptErrorPipeName,       // Output: pipe name
+        sizeof(scriptErrorPipeName),
+        &sa,                       // Pass SECURITY_ATTRIBUTES
+        hConsole,                  // Console handle
+        showWindow                 // ShowWindow function pointer
+    );
+
+    if (hErrorPipe == INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(hInboundPipe);
+        return -1;
+    }
+
+    // With the spawn service the command pipe also carries script output
+    BOOL spawnRequested = config->spawnService && config->ipcFraming;
+    DWORD commandPipeBufferSize = config->commandPipeBufferSize;
+    if (spawnRequested && config->outputPipeBufferSize > commandPipeBufferSize)
+        commandPipeBufferSize = config->outputPipeBufferSize;
+
     // Create shutdown pipe
     g_hCommandPipe = createNamedPipe(
         "PythonShutdownPipe",      // Pipe prefix
         pid,                       // Process ID
         randomSuffix,              // Random suffix
-        PIPE_ACCESS_OUTBOUND,      // Write-only access
+        PIPE_ACCESS_OUTBOUND | FILE_FLAG_OVERLAPPED, // Write-only access, overlapped connect
+        config->commandMessageMode ? PIPE_TYPE_MESSAGE : PIPE_TYPE_BYTE,
+        commandPipeBufferSize,
         scriptCommandPipeName,     // Output: pipe name
         sizeof(scriptCommandPipeName),
         &sa,                       // Pass SECURITY_ATTRIBUTES
@@ -224,13 +959,13 @@ int run_script(const char *pythonPath, const char *scriptPath)
     if (g_hCommandPipe == INVALID_HANDLE_VALUE)
     {
         CloseHandle(hInboundPipe);
+        CloseHandle(hErrorPipe);
         return -1; // Exit if the pipe couldn't be created
     }
 
-    // Pass the pipe names as arguments to the Python script
-    snprintf(commandLine, sizeof(commandLine),
-             "\"%s\" -u \"%s\" --output-pipe \"%s\" --shutdown-pipe \"%s\"",
-             pythonPath, scriptPath, scriptOutputPipeName, scriptCommandPipeName);
+    markStartupPhase(&g_startupProfile, "pipes_created");
+
+    g_commandFraming = config->ipcFraming;
 
     STARTUPINFO si = {sizeof(si), 0};
     si.dwFlags = STARTF_USESTDHANDLES;
@@ -243,69 +978,212 @@ int run_script(const char *pythonPath, const char *scriptPath)
         OPEN_EXISTING,
         FILE_ATTRIBUTE_NORMAL,
         NULL);
-    si.hStdError = si.hStdOutput;
+    si.hStdError = CreateFile(
+        scriptErrorPipeName,
+        GENERIC_WRITE,
+        0,
+        &sa,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
 
-    if (si.hStdOutput == INVALID_HANDLE_VALUE)
+    if (si.hStdOutput == INVALID_HANDLE_VALUE || si.hStdError == INVALID_HANDLE_VALUE)
     {
         displayErrorAndRestoreConsole("Failed to open named pipe for the Python process.", hConsole, showWindow);
+        if (si.hStdOutput != INVALID_HANDLE_VALUE)
+            CloseHandle(si.hStdOutput);
+        if (si.hStdError != INVALID_HANDLE_VALUE)
+            CloseHandle(si.hStdError);
         CloseHandle(hInboundPipe);
+        CloseHandle(hErrorPipe);
         CloseHandle(g_hCommandPipe);
         return -1;
     }
 
     PROCESS_INFORMATION pi = {0};
 
-    // Launch the Python process
-    if (!CreateProcess(NULL, commandLine, NULL, NULL, TRUE, 0, NULL, NULL, &si, &pi))
+    // Job object for the whole Python tree - closing it kills every script with the launcher
+    HANDLE hJob = createProcessJob();
+    if (!hJob)
+    {
+        printf("[WARNING] Failed to create job object, scripts will not be supervised. Error: %lu\n",
+               GetLastError());
+    }
+
+    // Priority and affinity limits on the job apply to every process in the Python tree
+    ProcessPolicy policy;
+    BOOL policyReady = FALSE;
+    if (hJob)
+    {
+        DWORD priorityClass = 0;
+        if (!parsePriorityClass(config->priorityClass, &priorityClass))
+            printf("[WARNING] Unknown priority class '%s', leaving the priority alone.\n", config->priorityClass);
+
+        policyReady = initProcessPolicy(&policy, hJob, priorityClass, (ULONG_PTR)config->affinityMask, config->ecoQos);
+        if (!policyReady)
+            printf("[WARNING] Failed to apply priority/affinity to the job. Error: %lu\n", GetLastError());
+    }
+
+    // Spawn service for Launcher.py's scripts; Launcher.py only uses it when told it exists.
+    // Its replies and script output go through the shared-memory ring when there is one and
+    // over the command pipe otherwise.
+    SpawnService spawnService;
+    ShmRing spawnRing = {0};
+    char spawnRingName[128];
+    BOOL ringCreated = spawnRequested && config->spawnRingSize > 0 &&
+        createShmRing(&spawnRing, pid, randomSuffix, config->spawnRingSize, spawnRingName, sizeof(spawnRingName));
+    if (spawnRequested && config->spawnRingSize > 0 && !ringCreated)
+        printf("[WARNING] Failed to create the spawn ring, script output goes over the command pipe. Error: %lu\n",
+               GetLastError());
+    FlowSettings flow = {FLOW_POLICY_COALESCE, config->flowBudgetBytes, config->flowRateBytes};
+    if (spawnRequested && !parseFlowPolicy(config->flowPolicy, &flow.policy))
+        printf("[WARNING] Unknown flow policy '%s', using coalesce.\n", config->flowPolicy);
+    BOOL spawnStarted = spawnRequested &&
+        initSpawnService(&spawnService, hJob, config->outputPipeBufferSize, &flow, config->coalesceWindowMs,
+                         config->nativeAnsi, ringCreated ? sendSpawnRecord : sendSpawnFrame,
+                         ringCreated ? &spawnRing : NULL);
+    if (spawnRequested && !spawnStarted)
+        printf("[WARNING] Spawn service disabled, Launcher.py will start scripts itself.\n");
+
+    // Interpreter, its options and the script, then the pipe names and features for Launcher.py
+    CommandLine commandLine;
+    initCommandLine(&commandLine);
+    appendCommandLineArgument(&commandLine, pythonPath);
+    appendCommandLine(&commandLine, " -u");
+    if (config->pythonFlags[0])
+        appendCommandLine(&commandLine, " %s", config->pythonFlags);
+    appendCommandLineArgument(&commandLine, scriptPath);
+    appendCommandLine(&commandLine, " --output-pipe");
+    appendCommandLineArgument(&commandLine, scriptOutputPipeName);
+    appendCommandLine(&commandLine, " --shutdown-pipe");
+    appendCommandLineArgument(&commandLine, scriptCommandPipeName);
+    appendCommandLine(&commandLine, " --shared-memory");
+    appendCommandLineArgument(&commandLine, sharedStateName);
+    if (config->commandMessageMode)
+        appendCommandLine(&commandLine, " --command-message-mode");
+    if (config->ipcFraming)
+        appendCommandLine(&commandLine, " --framed-ipc");
+    if (spawnStarted)
+        appendCommandLine(&commandLine, " --spawn-service");
+    if (spawnStarted && ringCreated)
+    {
+        appendCommandLine(&commandLine, " --spawn-ring");
+        appendCommandLineArgument(&commandLine, spawnRingName);
+    }
+
+    // Launch the Python process inside the job
+    BOOL launched = FALSE;
+    if (commandLineReady(&commandLine))
+    {
+        launched = hJob
+            ? createProcessInJob(hJob, commandLine.text, 0, &si, &pi)
+            : CreateProcess(NULL, commandLine.text, NULL, NULL, TRUE, 0, NULL, NULL, &si, &pi);
+    }
+    else
+    {
+        SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+    }
+    freeCommandLine(&commandLine);
+    if (!launched)
     {
         displayErrorAndRestoreConsole("CreateProcess failed.", hConsole, showWindow);
+        if (spawnStarted)
+            closeSpawnService(&spawnService);
+        if (ringCreated)
+            closeShmRing(&spawnRing);
+        if (hJob)
+            CloseHandle(hJob);
         CloseHandle(hInboundPipe);
+        CloseHandle(hErrorPipe);
         CloseHandle(g_hCommandPipe);
         CloseHandle(si.hStdOutput);
+        CloseHandle(si.hStdError);
         return -1;
     }
 
-    // Close the write handle in the parent process
+    // Close the write handles in the parent process
     CloseHandle(si.hStdOutput);
+    CloseHandle(si.hStdError);
+    markStartupPhase(&g_startupProfile, "process_created");
+
+    // Pre-start interpreters for scripts. Their pipe handles are given to the Python process,
+    // so this can only happen once it exists. Launcher.py starts scripts through the spawn
+    // service when it runs, so the pool would only sit idle then.
+    InterpreterPool pool = {0};
+    BOOL poolStarted = FALSE;
+    if (config->poolSize > 0 && spawnStarted)
+        printf("[INFO] Interpreter pool not started, scripts are started by the spawn service.\n");
+    else if (hJob && config->poolSize > 0)
+    {
+        char poolWorkerScript[MAX_PATH];
+        char claimEventName[64];
+        const char *scriptName = strrchr(scriptPath, '\\');
+        size_t dirLength = scriptName ? (size_t)(scriptName - scriptPath + 1) : 0;
+
+        snprintf(poolWorkerScript, sizeof(poolWorkerScript), "%.*spool_worker.py", (int)dirLength, scriptPath);
+        snprintf(claimEventName, sizeof(claimEventName), "Local\\MSFSPyScriptManagerPool_%lu_%d", pid, randomSuffix);
+
+        poolStarted = initInterpreterPool(&pool, &g_sharedState->pool, claimEventName, hJob, pi.hProcess,
+                                          pythonPath, poolWorkerScript, config->poolPreload, config->poolSize);
+        if (!poolStarted)
+            printf("[WARNING] Interpreter pool disabled, scripts will start cold.\n");
+        markStartupPhase(&g_startupProfile, "pool_started");
+    }
 
     printf("Reading Python script output...\n\n");
     printf("NOTE: Closing this window will close MSFS-PyScriptManager\n");
     printf("-------------------------------------------------------------------------------------------\n\n");
 
-    // Wait for the client to connect
+    // Wait for the client to connect both pipes, giving up if it exits or takes too long
     printf("Waiting for Launcher...\n");
-    BOOL connected = ConnectNamedPipe(g_hCommandPipe, NULL) || GetLastError() == ERROR_PIPE_CONNECTED;
+    HANDLE connectPipes[] = {g_hCommandPipe, hInboundPipe, hErrorPipe};
+    DWORD connectStartTick = GetTickCount();
+    BOOL connected = connectPipesOverlapped(connectPipes, 3, pi.hProcess, config->connectTimeoutMs);
+    g_metrics.runs++;
+    g_metrics.lastConnectWaitMs = GetTickCount() - connectStartTick;
+    g_metrics.connectWaitMs += g_metrics.lastConnectWaitMs;
+    DWORD exitCode = (DWORD)-1;
     if (!connected)
     {
-        displayErrorAndRestoreConsole("Failed to connect to shutdown named pipe.", hConsole, showWindow);
-        CloseHandle(hInboundPipe);
-        return -1;
+        displayErrorAndRestoreConsole("Failed to connect named pipes.", hConsole, showWindow);
+
+        // Launcher.py may still be starting; end it (and the pool) so a retry starts clean
+        if (hJob)
+            TerminateJobObject(hJob, 1);
+        else
+            TerminateProcess(pi.hProcess, 1);
+        goto cleanup;
     }
 
-    // Now, explicitly connect the output pipe after launching the process:
-    BOOL connectedOutput = ConnectNamedPipe(hInboundPipe, NULL) ||
-                           (GetLastError() == ERROR_PIPE_CONNECTED);
-    if (!connectedOutput)
+    markStartupPhase(&g_startupProfile, "pipes_connected");
+    printf("Launcher connected\n");
+
+    // A group given to this start goes through the same path as one from a second start
+    if (g_openGroupRequest[0])
     {
-        displayErrorAndRestoreConsole("Failed to connect to output named pipe.", hConsole, showWindow);
-        CloseHandle(hInboundPipe);
-        // Clean up shutdown pipe if needed...
-        return -1;
+        char command[ATTACH_REQUEST_SIZE + 16];
+        snprintf(command, sizeof(command), "attach %s", g_openGroupRequest);
+        if (!sendLauncherCommand(command))
+            printf("[WARNING] Failed to send the script group to Launcher.py.\n");
+        g_openGroupRequest[0] = '\0'; // Not reloaded when Launcher.py is restarted
     }
 
-    printf("Launcher connected\n");
+    // The console handler can now bound a shutdown of this run
+    g_hJob = hJob;
+    g_hPythonProcess = pi.hProcess;
+    if (policyReady)
+        applyProcessPolicy(&policy);
 
-    // Bring the console window to the foreground and minimize it
-    setForegroundWindow(hConsole);
-    Sleep(100);
-    showWindow(hConsole, SW_MINIMIZE);
+    // Bring the console window to the foreground and minimize it without holding up the loop
+    minimizeConsoleAsync(hConsole, showWindow, setForegroundWindow);
+    markStartupPhase(&g_startupProfile, "console_minimize_queued");
 
     // MAIN LOOP - Process data from inbound and outbound pipes
-    processPipeDataLoop(hInboundPipe, g_hCommandPipe, &pi);
+    processPipeDataLoop(hInboundPipe, hErrorPipe, g_sharedState, hJob, &pi, poolStarted ? &pool : NULL,
+                        policyReady ? &policy : NULL, spawnStarted ? &spawnService : NULL, config);
 
     // Wait for the Python process to complete
     WaitForSingleObject(pi.hProcess, INFINITE);
-    DWORD exitCode;
     GetExitCodeProcess(pi.hProcess, &exitCode);
 
     if (exitCode != 0)
@@ -318,29 +1196,234 @@ int run_script(const char *pythonPath, const char *scriptPath)
         printf("Python script completed successfully.\n");
     }
 
-    // Clean up
+    // Clean up, also after a failed connect
+cleanup:
+    g_hPythonProcess = NULL;
+    g_hJob = NULL;
+    if (g_hShutdownAck)
+    {
+        CloseHandle(g_hShutdownAck);
+        g_hShutdownAck = NULL;
+    }
+    if (spawnStarted)
+        closeSpawnService(&spawnService); // Stops its writes before the command pipe goes away
+    if (ringCreated)
+        closeShmRing(&spawnRing);
     CloseHandle(hInboundPipe);
+    CloseHandle(hErrorPipe);
+    EnterCriticalSection(&g_commandPipeLock);
     if (g_hCommandPipe)
     {
         CloseHandle(g_hCommandPipe);
+        g_hCommandPipe = NULL;
     }
+    LeaveCriticalSection(&g_commandPipeLock);
+    if (poolStarted)
+        closeInterpreterPool(&pool);
     CloseHandle(pi.hProcess);
     CloseHandle(pi.hThread);
 
+    // Report the tree's totals, then close the job which terminates any leftover scripts
+    if (hJob)
+    {
+        JobAccounting accounting;
+        if (queryJobAccounting(hJob, &accounting))
+            printJobAccounting(&accounting);
+        CloseHandle(hJob);
+    }
+
+    finishStartupProfile(g_sharedState, config, TRUE);
+
+    SharedState *sharedState = g_sharedState;
+    g_sharedState = NULL;
+    closeSharedState(sharedState, hSharedState);
+
     return exitCode;
 }
 
-int main()
+// Run the Python side and relaunch it with exponential backoff whenever it exits with an error.
+// Pipes, shared state and the job are re-created by run_script on each attempt. A run that
+// stays up for the stable period resets the backoff and the restart count. Returns the last
+// exit code.
+int superviseScript(const char *pythonPath, const char *scriptPath, const LauncherConfig *config)
 {
-    // Specify the path to the Python interpreter and the script to be executed.
-    const char *pythonPath = ".\\WinPython\\python-3.13.0rc1.amd64\\pythonw.exe";
-    const char *scriptPath = ".\\Launcher\\LauncherScript\\launcher.py";
+    DWORD delayMs = config->restartDelayMs;
+    DWORD restarts = 0;
+
+    while (1)
+    {
+        DWORD startTick = GetTickCount();
+        int result = run_script(pythonPath, scriptPath, config);
+
+        if (result == 0 || WaitForSingleObject(g_shutdownEvent, 0) == WAIT_OBJECT_0)
+            return result;
+
+        // A stable run starts over, so only back-to-back failures count towards the limit
+        if (GetTickCount() - startTick >= config->restartStableSeconds * 1000)
+        {
+            delayMs = config->restartDelayMs;
+            restarts = 0;
+        }
+
+        if (config->maxRestarts > 0 && restarts >= config->maxRestarts)
+        {
+            printf("[ERROR] Launcher.py failed %lu times, giving up.\n", restarts + 1);
+            return result;
+        }
+
+        restarts++;
+        printf("[WARNING] Launcher.py exited with code %d, restarting in %lu ms (restart %lu)\n",
+               result, delayMs, restarts);
+
+        // Closing the console during the backoff ends supervision
+        if (WaitForSingleObject(g_shutdownEvent, delayMs) == WAIT_OBJECT_0)
+            return result;
+
+        delayMs = delayMs * 2 > config->maxRestartDelayMs ? config->maxRestartDelayMs : delayMs * 2;
+    }
+}
+
+// AttachRequestFn: hand a second start's request to Launcher.py, which acts on it.
+BOOL forwardAttachRequest(const char *request)
+{
+    char command[ATTACH_REQUEST_SIZE + 16];
+
+    // Requests become one command line, so they must be one line
+    if (strpbrk(request, "\r\n") || (strcmp(request, "focus") != 0 && strncmp(request, "group ", 6) != 0))
+    {
+        printf("[WARNING] Ignoring unknown attach request.\n");
+        return FALSE;
+    }
+    snprintf(command, sizeof(command), "attach %s", request);
+    printf("[INFO] Another launch was started, forwarding '%s' to Launcher.py.\n", request);
+    return sendLauncherCommand(command);
+}
+
+// Build the "group <path>" attach request for config->openGroup, with the path made absolute
+// and in UTF-8, which is how Launcher.py decodes commands. A path given on the command line is
+// taken from the wide command line, so characters outside the ANSI code page survive.
+BOOL buildOpenGroupRequest(const LauncherConfig *config, int argc, char *argv[], char *request, DWORD requestSize)
+{
+    WCHAR path[CONFIG_STRING_SIZE];
+    WCHAR fullPath[MAX_PATH * 2];
+    BOOL found = FALSE;
+
+    HMODULE shell32 = LoadLibrary("shell32.dll");
+    CommandLineToArgvW_t commandLineToArgvW =
+        shell32 ? (CommandLineToArgvW_t)GetProcAddress(shell32, "CommandLineToArgvW") : NULL;
+    int wideCount = 0;
+    LPWSTR *wideArgv = commandLineToArgvW ? commandLineToArgvW(GetCommandLineW(), &wideCount) : NULL;
+    for (int i = 1; wideArgv && i < argc && i < wideCount && !found; i++)
+    {
+        // The ANSI argument is the same one with unmappable characters replaced
+        if (strcmp(argv[i], config->openGroup) == 0 && wcslen(wideArgv[i]) < CONFIG_STRING_SIZE)
+        {
+            wcscpy(path, wideArgv[i]);
+            found = TRUE;
+        }
+    }
+    if (wideArgv)
+        LocalFree(wideArgv);
+
+    // Otherwise it came from the settings file, which is read in the ANSI code page
+    if (!found && !MultiByteToWideChar(CP_ACP, 0, config->openGroup, -1, path, CONFIG_STRING_SIZE))
+        return FALSE;
+
+    DWORD fullLength = GetFullPathNameW(path, MAX_PATH * 2, fullPath, NULL);
+    if (!fullLength || fullLength >= MAX_PATH * 2)
+        return FALSE;
+
+    strcpy(request, "group ");
+    return WideCharToMultiByte(CP_UTF8, 0, fullPath, -1, request + 6, (int)(requestSize - 6), NULL, NULL) > 0;
+}
+
+// Send this start's request to the running launcher. Returns the exit code of this start.
+int attachToRunningLauncher(SingleInstance *instance, const char *request)
+{
+    // The running launcher's window may only take the foreground if this start allows it
+    HMODULE user32 = LoadLibrary("user32.dll");
+    AllowSetForegroundWindow_t allowSetForegroundWindow =
+        user32 ? (AllowSetForegroundWindow_t)GetProcAddress(user32, "AllowSetForegroundWindow") : NULL;
+    if (allowSetForegroundWindow)
+        allowSetForegroundWindow(ASFW_ANY);
+
+    printf("[INFO] MSFS-PyScriptManager is already running, sending '%s' to it.\n", request);
+    return sendAttachRequest(instance, request) ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    // Origin of the start-up trace, taken before anything else runs
+    LARGE_INTEGER mainQpc;
+    QueryPerformanceCounter(&mainQpc);
+
+    // Launcher settings
+    LauncherConfig config;
+    initDefaultConfig(&config);
+    if (!loadConfig(&config, argc, argv))
+    {
+        printConfigUsage();
+        return 0;
+    }
+    initStartupProfile(&g_startupProfile, config.profileStartup, mainQpc.QuadPart);
+    markStartupPhase(&g_startupProfile, "config_loaded");
+
+    // What this start asks of Launcher.py: the running one's, or its own once it is up
+    char attachRequest[ATTACH_REQUEST_SIZE] = "focus";
+    if (config.openGroup[0] && !buildOpenGroupRequest(&config, argc, argv, attachRequest, sizeof(attachRequest)))
+    {
+        printf("[WARNING] Ignoring invalid script group path: %s\n", config.openGroup);
+        strcpy(attachRequest, "focus");
+    }
+
+    // A second start hands its request to the running launcher instead of starting another UI
+    SingleInstance instance = {0};
+    if (config.singleInstance && !config.headlessGroup[0] && !acquireSingleInstance(&instance))
+    {
+        int attachResult = attachToRunningLauncher(&instance, attachRequest);
+        if (attachResult != 0)
+        {
+            printf("Press any key to exit...\n");
+            getchar();
+        }
+        return attachResult;
+    }
+
+    if (strcmp(attachRequest, "focus") != 0)
+        strcpy(g_openGroupRequest, attachRequest);
+
+    // Inherited by Launcher.py and every script, so set before anything is started
+    applyConfigEnvironment(&config);
+
+    // The Python interpreter and the script to be executed
+    const char *pythonPath = config.pythonPath;
+    const char *scriptPath = config.scriptPath;
+
+    // Runs alongside the console and pipe set-up below
+    Preflight preflight = {0};
+    if (config.preflight && !startPreflight(&preflight, pythonPath, &config))
+        printf("[WARNING] Failed to start the preflight stage.\n");
 
     // Register the console control handler
+    g_shutdownEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    InitializeCriticalSection(&g_commandPipeLock);
+    initLauncherMetrics(&g_metrics);
     SetConsoleCtrlHandler(ConsoleHandler, TRUE);
+    srand((unsigned int)time(NULL) ^ GetCurrentProcessId()); // Seed for unique pipe names
+    if (instance.mutex && !startAttachServer(&instance, forwardAttachRequest))
+        printf("[WARNING] Failed to start the attach server, a second start will not reach this one.\n");
 
-    // Run the Python script and retrieve the exit code.
-    int result = run_script(pythonPath, scriptPath);
+    // Run the Python script and retrieve the exit code, relaunching it if it fails and
+    // supervision is enabled. Headless mode runs a script group directly instead.
+    int result;
+    if (config.headlessGroup[0])
+        result = runHeadless(pythonPath, config.headlessGroup, &config, g_shutdownEvent);
+    else
+        result = config.supervise
+            ? superviseScript(pythonPath, scriptPath, &config)
+            : run_script(pythonPath, scriptPath, &config);
+    closePreflight(&preflight);
+    closeSingleInstance(&instance);
 
     // If there was an error, prompt the user to press a key before exiting.
     if (result != 0)
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <string.h>
+#include "Metrics.h"
+
+void initLauncherMetrics(LauncherMetrics *metrics)
+{
+    ZeroMemory(metrics, sizeof(*metrics));
+    InitializeCriticalSection(&metrics->lock);
+    QueryPerformanceFrequency(&metrics->frequency);
+    metrics->startQpc = beginLoopWakeup();
+    metrics->lastQueryQpc = metrics->startQpc;
+}
+
+LONGLONG beginLoopWakeup(void)
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+void endLoopWakeup(LauncherMetrics *metrics, LONGLONG startQpc)
+{
+    LONGLONG elapsedUs = (beginLoopWakeup() - startQpc) * 1000000 / metrics->frequency.QuadPart;
+
+    metrics->loopIterations++;
+    metrics->busyUs += (ULONGLONG)elapsedUs;
+    if (elapsedUs >= METRICS_STALL_US)
+        metrics->stalls++;
+    if (elapsedUs > metrics->longestWakeupUs)
+        metrics->longestWakeupUs = (DWORD)elapsedUs;
+}
+
+void countCommandWrite(LauncherMetrics *metrics, BOOL written)
+{
+    EnterCriticalSection(&metrics->lock);
+    if (written)
+        metrics->commandWrites++;
+    else
+        metrics->commandWriteFailures++;
+    LeaveCriticalSection(&metrics->lock);
+}
+
+void countSpawnSend(LauncherMetrics *metrics, DWORD length, BOOL sent)
+{
+    EnterCriticalSection(&metrics->lock);
+    if (sent)
+    {
+        metrics->spawnFrames++;
+        metrics->spawnBytes += length;
+    }
+    else
+    {
+        metrics->spawnSendFailures++;
+    }
+    LeaveCriticalSection(&metrics->lock);
+}
+
+// Bytes per second between two totals over elapsed QPC ticks.
+static ULONGLONG ratePerSecond(const LauncherMetrics *metrics, ULONGLONG now, ULONGLONG then, LONGLONG elapsed)
+{
+    return elapsed > 0 ? (now - then) * metrics->frequency.QuadPart / elapsed : 0;
+}
+
+DWORD formatLauncherMetrics(LauncherMetrics *metrics, char *buffer, DWORD size)
+{
+    LONGLONG now = beginLoopWakeup();
+    LONGLONG elapsed = now - metrics->lastQueryQpc;
+
+    EnterCriticalSection(&metrics->lock);
+    ULONGLONG commandWrites = metrics->commandWrites;
+    ULONGLONG commandWriteFailures = metrics->commandWriteFailures;
+    ULONGLONG spawnFrames = metrics->spawnFrames;
+    ULONGLONG spawnBytes = metrics->spawnBytes;
+    ULONGLONG spawnSendFailures = metrics->spawnSendFailures;
+    LeaveCriticalSection(&metrics->lock);
+
+    int length = snprintf(buffer, size,
+                          "uptime_ms=%llu\n"
+                          "runs=%lu\n"
+                          "connect_wait_ms=%lu\n"
+                          "connect_wait_total_ms=%llu\n"
+                          "loop_iterations=%llu\n"
+                          "stdout_reads=%llu\n"
+                          "stderr_reads=%llu\n"
+                          "stdout_bytes=%llu\n"
+                          "stderr_bytes=%llu\n"
+                          "stdout_bytes_per_s=%llu\n"
+                          "stderr_bytes_per_s=%llu\n"
+                          "timer_ticks=%llu\n"
+                          "flush_timeouts=%llu\n"
+                          "busy_us=%llu\n"
+                          "stalls=%llu\n"
+                          "longest_wakeup_us=%lu\n"
+                          "command_writes=%llu\n"
+                          "command_write_failures=%llu\n"
+                          "spawn_frames=%llu\n"
+                          "spawn_bytes=%llu\n"
+                          "spawn_bytes_per_s=%llu\n"
+                          "spawn_send_failures=%llu\n",
+                          (ULONGLONG)((now - metrics->startQpc) * 1000 / metrics->frequency.QuadPart),
+                          metrics->runs, metrics->lastConnectWaitMs, metrics->connectWaitMs,
+                          metrics->loopIterations, metrics->stdoutReads, metrics->stderrReads,
+                          metrics->stdoutBytes, metrics->stderrBytes,
+                          ratePerSecond(metrics, metrics->stdoutBytes, metrics->lastStdoutBytes, elapsed),
+                          ratePerSecond(metrics, metrics->stderrBytes, metrics->lastStderrBytes, elapsed),
+                          metrics->timerTicks, metrics->flushTimeouts, metrics->busyUs, metrics->stalls,
+                          metrics->longestWakeupUs, commandWrites, commandWriteFailures, spawnFrames, spawnBytes,
+                          ratePerSecond(metrics, spawnBytes, metrics->lastSpawnBytes, elapsed), spawnSendFailures);
+    if (length <= 0 || (DWORD)length >= size)
+        return 0;
+
+    metrics->lastQueryQpc = now;
+    metrics->lastStdoutBytes = metrics->stdoutBytes;
+    metrics->lastStderrBytes = metrics->stderrBytes;
+    metrics->lastSpawnBytes = spawnBytes;
+    return (DWORD)length;
+}
@@ -0,0 +1,70 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <windows.h>
+
+// Wakeups of the pipe loop taking longer than this to handle are counted as stalls
+#define METRICS_STALL_US 20000
+
+// Counters of the launcher's own work, for watching relay throughput and stalls while the
+// UI runs. Launcher.py asks for them with a "stats" control frame and gets the text from
+// formatLauncherMetrics back as a control frame on the command pipe (launcher_metrics.py).
+//
+// The pipe loop counters are only touched by the pipe loop thread, which also answers the
+// queries. Command pipe and spawn service sends happen on several threads and take lock.
+typedef struct
+{
+    LARGE_INTEGER frequency;    // QPC ticks per second
+    LONGLONG startQpc;          // When the launcher started
+
+    // run_script
+    DWORD runs;                 // Launcher.py starts, restarts included
+    DWORD lastConnectWaitMs;    // Wait for Launcher.py to connect its pipes, last start
+    ULONGLONG connectWaitMs;    // Same, all starts
+
+    // Pipe loop
+    ULONGLONG loopIterations;   // Returns from the loop's wait
+    ULONGLONG stdoutReads;      // Completed reads of Launcher.py's stdout
+    ULONGLONG stderrReads;
+    ULONGLONG stdoutBytes;      // Relayed from Launcher.py's stdout
+    ULONGLONG stderrBytes;
+    ULONGLONG timerTicks;       // Heartbeat timer wakeups
+    ULONGLONG flushTimeouts;    // Wakeups only to flush batched console output
+    ULONGLONG busyUs;           // Time spent handling wakeups
+    ULONGLONG stalls;           // Wakeups that took at least METRICS_STALL_US
+    DWORD longestWakeupUs;
+
+    // Sends to Launcher.py (under lock)
+    CRITICAL_SECTION lock;
+    ULONGLONG commandWrites;    // Commands and replies written to the command pipe
+    ULONGLONG commandWriteFailures;
+    ULONGLONG spawnFrames;      // Spawn service replies and script output sent
+    ULONGLONG spawnBytes;
+    ULONGLONG spawnSendFailures; // Failed pipe writes or records dropped from the spawn ring
+
+    // Totals at the previous query, for the rates
+    LONGLONG lastQueryQpc;
+    ULONGLONG lastStdoutBytes;
+    ULONGLONG lastStderrBytes;
+    ULONGLONG lastSpawnBytes;
+} LauncherMetrics;
+
+void initLauncherMetrics(LauncherMetrics *metrics);
+
+// Current QPC value, to pass to endLoopWakeup once the wakeup is handled.
+LONGLONG beginLoopWakeup(void);
+
+// Account for one handled wakeup of the pipe loop.
+void endLoopWakeup(LauncherMetrics *metrics, LONGLONG startQpc);
+
+// Count one write to the command pipe. Any thread.
+void countCommandWrite(LauncherMetrics *metrics, BOOL written);
+
+// Count one spawn service send of length bytes. Any thread.
+void countSpawnSend(LauncherMetrics *metrics, DWORD length, BOOL sent);
+
+// Write the counters as "name=value" lines, with byte rates since the previous call. Pipe
+// loop thread only. Returns the length written, 0 if the buffer is too small.
+DWORD formatLauncherMetrics(LauncherMetrics *metrics, char *buffer, DWORD size);
+
+#endif // METRICS_H
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "PipeReader.h"
+
+// Initialize a pipe reader for the given overlapped pipe handle.
+BOOL initPipeReader(PipeReader *reader, HANDLE pipe, DWORD bufferSize)
+{
+    ZeroMemory(reader, sizeof(*reader));
+    reader->pipe = pipe;
+    reader->bufferSize = bufferSize;
+    reader->buffer = (char *)malloc(bufferSize);
+    reader->overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL); // Manual reset
+    return reader->buffer && reader->overlapped.hEvent;
+}
+
+// Issue the next overlapped read. Completion (synchronous or not) signals the reader's event.
+void beginPipeRead(PipeReader *reader)
+{
+    if (reader->closed || reader->pending)
+        return;
+
+    ResetEvent(reader->overlapped.hEvent);
+    if (ReadFile(reader->pipe, reader->buffer, reader->bufferSize, NULL, &reader->overlapped) ||
+        GetLastError() == ERROR_IO_PENDING)
+    {
+        reader->pending = TRUE;
+        return;
+    }
+
+    // ERROR_BROKEN_PIPE means the writer went away, anything else is unexpected
+    if (GetLastError() != ERROR_BROKEN_PIPE)
+        printf("[ERROR] Failed to read from pipe. Error: %lu\n", GetLastError());
+    reader->closed = TRUE;
+}
+
+// Collect the result of a completed read. Returns the number of bytes placed in the buffer.
+DWORD completePipeRead(PipeReader *reader)
+{
+    DWORD bytesRead = 0;
+    reader->pending = FALSE;
+
+    if (!GetOverlappedResult(reader->pipe, &reader->overlapped, &bytesRead, FALSE))
+    {
+        if (GetLastError() != ERROR_BROKEN_PIPE)
+            printf("[ERROR] Pipe read failed. Error: %lu\n", GetLastError());
+        reader->closed = TRUE;
+        return 0;
+    }
+    return bytesRead;
+}
+
+// Cancel any outstanding read and release the reader's resources. The pipe handle is not closed.
+void closePipeReader(PipeReader *reader)
+{
+    if (reader->pending)
+    {
+        DWORD ignored;
+        CancelIo(reader->pipe);
+        GetOverlappedResult(reader->pipe, &reader->overlapped, &ignored, TRUE); // Wait for cancel
+        reader->pending = FALSE;
+    }
+    if (reader->overlapped.hEvent)
+    {
+        CloseHandle(reader->overlapped.hEvent);
+        reader->overlapped.hEvent = NULL;
+    }
+    free(reader->buffer);
+    reader->buffer = NULL;
+}
@@ -0,0 +1,31 @@
+#ifndef PIPE_READER_H
+#define PIPE_READER_H
+
+#include <windows.h>
+
+// Tracks an overlapped read that is kept outstanding on a pipe so the main loop can block on
+// its completion event instead of polling the pipe.
+typedef struct
+{
+    HANDLE pipe;            // Pipe handle (must be opened with FILE_FLAG_OVERLAPPED)
+    OVERLAPPED overlapped;  // Overlapped state, hEvent is signalled when the read completes
+    char *buffer;           // Destination buffer for the outstanding read
+    DWORD bufferSize;       // Size of buffer (bytes requested per read)
+    BOOL pending;           // TRUE while a read is outstanding
+    BOOL closed;            // TRUE once the writer closed its end of the pipe
+} PipeReader;
+
+// Initialize a pipe reader for the given overlapped pipe handle.
+// Returns TRUE if the read buffer and completion event were created.
+BOOL initPipeReader(PipeReader *reader, HANDLE pipe, DWORD bufferSize);
+
+// Issue the next overlapped read. Completion (synchronous or not) signals the reader's event.
+void beginPipeRead(PipeReader *reader);
+
+// Collect the result of a completed read. Returns the number of bytes placed in the buffer.
+DWORD completePipeRead(PipeReader *reader);
+
+// Cancel any outstanding read and release the reader's resources. The pipe handle is not closed.
+void closePipeReader(PipeReader *reader);
+
+#endif // PIPE_READER_H
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PostMortem.h"
+
+// MINIDUMP_TYPE flags (dbghelp.h is not part of the TinyCC headers)
+#define MINIDUMP_WITH_DATA_SEGS                0x00000001
+#define MINIDUMP_WITH_HANDLE_DATA              0x00000004
+#define MINIDUMP_WITH_INDIRECTLY_REFERENCED    0x00000040
+#define MINIDUMP_WITH_PROCESS_THREAD_DATA      0x00000100
+#define MINIDUMP_WITH_THREAD_INFO              0x00001000
+
+// Enough to walk every thread's stack, including the Tk and Python interpreter state they reference
+#define POST_MORTEM_DUMP_TYPE (MINIDUMP_WITH_DATA_SEGS | MINIDUMP_WITH_HANDLE_DATA | \
+                               MINIDUMP_WITH_INDIRECTLY_REFERENCED | MINIDUMP_WITH_PROCESS_THREAD_DATA | \
+                               MINIDUMP_WITH_THREAD_INFO)
+
+typedef BOOL (WINAPI *MiniDumpWriteDump_t)(HANDLE, DWORD, HANDLE, DWORD, void *, void *, void *);
+
+// Loaded on first use so the launcher does not depend on dbghelp.dll at start-up
+static MiniDumpWriteDump_t loadMiniDumpWriteDump(void)
+{
+    static MiniDumpWriteDump_t miniDumpWriteDump = NULL;
+    static BOOL attempted = FALSE;
+
+    if (!attempted)
+    {
+        attempted = TRUE;
+        HMODULE dbghelp = LoadLibrary("dbghelp.dll");
+        if (dbghelp)
+            miniDumpWriteDump = (MiniDumpWriteDump_t)GetProcAddress(dbghelp, "MiniDumpWriteDump");
+    }
+    return miniDumpWriteDump;
+}
+
+// Prepare captures into directory.
+BOOL initPostMortem(PostMortem *postMortem, const char *directory, DWORD tailBytes)
+{
+    ZeroMemory(postMortem, sizeof(*postMortem));
+    strncpy(postMortem->directory, directory, sizeof(postMortem->directory) - 1);
+    postMortem->tailBytes = tailBytes;
+    postMortem->tailBuffer = (char *)malloc(tailBytes ? tailBytes : 1);
+    return postMortem->tailBuffer != NULL;
+}
+
+// Build "<directory>\<reason>_<yyyymmdd-hhmmss>_<pid><extension>", creating the directory.
+static BOOL buildCapturePath(const PostMortem *postMortem, const char *reason, DWORD pid,
+                             const char *extension, char *path, size_t pathSize)
+{
+    SYSTEMTIME now;
+    GetLocalTime(&now);
+    CreateDirectory(postMortem->directory, NULL); // Fails harmlessly if it exists
+
+    int length = snprintf(path, pathSize, "%s\\%s_%04u%02u%02u-%02u%02u%02u_%lu%s", postMortem->directory,
+                          reason, now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond,
+                          pid, extension);
+    return length > 0 && length < (int)pathSize;
+}
+
+// Write the tail of the output ring to path.
+static BOOL writeTail(PostMortem *postMortem, const char *path, const char *note, const ConsoleWriter *writer)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return FALSE;
+
+    DWORD length = consoleWriterCopyTail(writer, postMortem->tailBuffer, postMortem->tailBytes);
+    fprintf(file, "%s\r\n--- last %lu bytes of output ---\r\n", note, length);
+    fwrite(postMortem->tailBuffer, 1, length, file);
+    fclose(file);
+    return TRUE;
+}
+
+// Write a minidump of a live process and the matching output tail.
+BOOL capturePostMortemDump(PostMortem *postMortem, HANDLE process, DWORD pid, const char *reason,
+                           const ConsoleWriter *writer)
+{
+    char dumpPath[MAX_PATH];
+    char tailPath[MAX_PATH];
+    if (!buildCapturePath(postMortem, reason, pid, ".dmp", dumpPath, sizeof(dumpPath)) ||
+        !buildCapturePath(postMortem, reason, pid, ".log", tailPath, sizeof(tailPath)))
+        return FALSE;
+
+    BOOL dumped = FALSE;
+    MiniDumpWriteDump_t miniDumpWriteDump = loadMiniDumpWriteDump();
+    if (!miniDumpWriteDump)
+    {
+        printf("[WARNING] dbghelp.dll MiniDumpWriteDump is not available, no dump written.\n");
+    }
+    else
+    {
+        HANDLE file = CreateFile(dumpPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            dumped = miniDumpWriteDump(process, pid, file, POST_MORTEM_DUMP_TYPE, NULL, NULL, NULL);
+            CloseHandle(file);
+            if (!dumped)
+                DeleteFile(dumpPath);
+        }
+        if (dumped)
+            printf("[INFO] Wrote minidump of PID %lu to %s\n", pid, dumpPath);
+        else
+            printf("[ERROR] Failed to write minidump of PID %lu. Error: %lu\n", pid, GetLastError());
+    }
+
+    char note[128];
+    snprintf(note, sizeof(note), "MSFS-PyScriptManager post-mortem: %s, PID %lu", reason, pid);
+    if (writeTail(postMortem, tailPath, note, writer))
+        printf("[INFO] Wrote output tail to %s\n", tailPath);
+    return dumped;
+}
+
+// Write only the output tail, for a process that has already exited.
+BOOL capturePostMortemTail(PostMortem *postMortem, DWORD pid, const char *reason, DWORD exitCode,
+                           const ConsoleWriter *writer)
+{
+    char tailPath[MAX_PATH];
+    if (!buildCapturePath(postMortem, reason, pid, ".log", tailPath, sizeof(tailPath)))
+        return FALSE;
+
+    char note[128];
+    snprintf(note, sizeof(note), "MSFS-PyScriptManager post-mortem: %s, PID %lu, exit code 0x%08lX",
+             reason, pid, exitCode);
+    if (!writeTail(postMortem, tailPath, note, writer))
+        return FALSE;
+
+    printf("[INFO] Wrote output tail to %s\n", tailPath);
+    return TRUE;
+}
+
+// Release the tail buffer.
+void closePostMortem(PostMortem *postMortem)
+{
+    free(postMortem->tailBuffer);
+    postMortem->tailBuffer = NULL;
+}
@@ -0,0 +1,32 @@
+#ifndef POST_MORTEM_H
+#define POST_MORTEM_H
+
+#include <windows.h>
+#include "ConsoleWriter.h"
+
+// Post-mortem capture for Launcher.py: a minidump of the process when it stops responding and
+// the tail of its output from the console writer's ring, written side by side into a folder.
+typedef struct
+{
+    char directory[MAX_PATH];  // Folder the captures are written to
+    DWORD tailBytes;           // Output kept next to each capture
+    char *tailBuffer;          // Scratch buffer for the tail
+} PostMortem;
+
+// Prepare captures into directory (created when the first capture is written).
+// Returns FALSE if the tail buffer cannot be allocated.
+BOOL initPostMortem(PostMortem *postMortem, const char *directory, DWORD tailBytes);
+
+// Write "<reason>_<time>_<pid>.dmp" for a live process (dbghelp is loaded on first use) and
+// the matching ".log" with the output tail. Returns FALSE if the dump could not be written.
+BOOL capturePostMortemDump(PostMortem *postMortem, HANDLE process, DWORD pid, const char *reason,
+                           const ConsoleWriter *writer);
+
+// Write only the output tail, for a process that has already exited.
+BOOL capturePostMortemTail(PostMortem *postMortem, DWORD pid, const char *reason, DWORD exitCode,
+                           const ConsoleWriter *writer);
+
+// Release the tail buffer.
+void closePostMortem(PostMortem *postMortem);
+
+#endif // POST_MORTEM_H
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Preflight.h"
+#include "CommandLine.h"
+
+// Background processing mode definitions (newer than the TinyCC headers)
+#ifndef THREAD_MODE_BACKGROUND_BEGIN
+#define THREAD_MODE_BACKGROUND_BEGIN 0x00010000
+#define THREAD_MODE_BACKGROUND_END   0x00020000
+#endif
+
+// Read size used for prefetching
+#define PREFETCH_CHUNK_SIZE (1024 * 1024)
+
+// Largest wait for compileall before the stamp is left for the next start
+#define PREFLIGHT_COMPILE_TIMEOUT_MS (10 * 60 * 1000)
+
+// Directories never imported at run time, skipped while prefetching
+static const char *g_prefetchSkip[] = {"test", "tests", "idle_test", "Doc", "include"};
+
+// TRUE if name ends with extension (case insensitive).
+static BOOL hasExtension(const char *name, const char *extension)
+{
+    size_t nameLength = strlen(name);
+    size_t extensionLength = strlen(extension);
+    return nameLength > extensionLength && _stricmp(name + nameLength - extensionLength, extension) == 0;
+}
+
+static ULONGLONG fileTimeValue(const FILETIME *time)
+{
+    return ((ULONGLONG)time->dwHighDateTime << 32) | time->dwLowDateTime;
+}
+
+// Newest last-write time of the .py files under a directory, 0 if there are none.
+static ULONGLONG newestSource(const char *directory)
+{
+    char pattern[MAX_PATH];
+    WIN32_FIND_DATA data;
+    ULONGLONG newest = 0;
+
+    if (snprintf(pattern, sizeof(pattern), "%s\\*", directory) >= (int)sizeof(pattern))
+        return 0;
+    HANDLE find = FindFirstFile(pattern, &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return 0;
+
+    do
+    {
+        ULONGLONG time = 0;
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            char child[MAX_PATH];
+            if (data.cFileName[0] != '.' && strcmp(data.cFileName, "__pycache__") != 0 &&
+                snprintf(child, sizeof(child), "%s\\%s", directory, data.cFileName) < (int)sizeof(child))
+                time = newestSource(child);
+        }
+        else if (hasExtension(data.cFileName, ".py"))
+        {
+            time = fileTimeValue(&data.ftLastWriteTime);
+        }
+        if (time > newest)
+            newest = time;
+    } while (FindNextFile(find, &data));
+
+    FindClose(find);
+    return newest;
+}
+
+// Read the time stored by the last completed compile, 0 if there is none.
+static ULONGLONG readStamp(const char *path)
+{
+    char text[32] = {0};
+    FILE *file = fopen(path, "r");
+    if (!file)
+        return 0;
+    fgets(text, sizeof(text), file);
+    fclose(file);
+    return strtoull(text, NULL, 16);
+}
+
+static void writeStamp(const char *path, ULONGLONG time)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        printf("[WARNING] Preflight could not write %s.\n", path);
+        return;
+    }
+    fprintf(file, "%llx\n", time);
+    fclose(file);
+}
+
+// Start compileall on the compile directories if any source is newer than the stamp.
+// Returns the process handle, NULL if nothing needs compiling or it failed to start.
+static HANDLE startCompile(Preflight *preflight, ULONGLONG *newestTime)
+{
+    char directories[CONFIG_STRING_SIZE];
+    CommandLine commandLine;
+    ULONGLONG newest = 0;
+    DWORD directoryCount = 0;
+
+    initCommandLine(&commandLine);
+    appendCommandLineArgument(&commandLine, preflight->pythonPath);
+    appendCommandLine(&commandLine, " -m compileall -q");
+
+    strcpy(directories, preflight->compileDirectories);
+    for (char *directory = strtok(directories, ";"); directory; directory = strtok(NULL, ";"))
+    {
+        DWORD attributes = GetFileAttributes(directory);
+        if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+            continue;
+
+        ULONGLONG time = newestSource(directory);
+        if (time > newest)
+            newest = time;
+        appendCommandLineArgument(&commandLine, directory);
+        directoryCount++;
+    }
+
+    HANDLE process = NULL;
+    if (directoryCount && newest > readStamp(preflight->stampPath))
+    {
+        STARTUPINFO si = {sizeof(STARTUPINFO)};
+        PROCESS_INFORMATION pi = {0};
+        if (commandLineReady(&commandLine) &&
+            CreateProcess(NULL, commandLine.text, NULL, NULL, FALSE, CREATE_NO_WINDOW | IDLE_PRIORITY_CLASS,
+                          NULL, NULL, &si, &pi))
+        {
+            CloseHandle(pi.hThread);
+            process = pi.hProcess;
+            printf("[INFO] Preflight: sources changed, compiling bytecode in the background.\n");
+        }
+        else
+        {
+            printf("[WARNING] Preflight could not start compileall. Error: %lu\n", GetLastError());
+        }
+    }
+    freeCommandLine(&commandLine);
+    *newestTime = newest;
+    return process;
+}
+
+// Read every prefetchable file under a directory into the file cache, within the budget.
+static void prefetchDirectory(const char *directory, char *buffer, ULONGLONG *remaining, DWORD *fileCount)
+{
+    char pattern[MAX_PATH];
+    WIN32_FIND_DATA data;
+
+    if (snprintf(pattern, sizeof(pattern), "%s\\*", directory) >= (int)sizeof(pattern))
+        return;
+    HANDLE find = FindFirstFile(pattern, &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+
+    do
+    {
+        char path[MAX_PATH];
+        if (data.cFileName[0] == '.' ||
+            snprintf(path, sizeof(path), "%s\\%s", directory, data.cFileName) >= (int)sizeof(path))
+            continue;
+
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            BOOL skip = FALSE;
+            for (size_t i = 0; i < sizeof(g_prefetchSkip) / sizeof(g_prefetchSkip[0]); i++)
+                skip = skip || _stricmp(data.cFileName, g_prefetchSkip[i]) == 0;
+            if (!skip)
+                prefetchDirectory(path, buffer, remaining, fileCount);
+            continue;
+        }
+
+        ULONGLONG size = ((ULONGLONG)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        if (size > *remaining ||
+            !(hasExtension(data.cFileName, ".zip") || hasExtension(data.cFileName, ".pyc") ||
+              hasExtension(data.cFileName, ".pyd") || hasExtension(data.cFileName, ".dll")))
+            continue;
+
+        HANDLE file = CreateFile(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                                 OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            continue;
+        DWORD bytesRead;
+        while (ReadFile(file, buffer, PREFETCH_CHUNK_SIZE, &bytesRead, NULL) && bytesRead > 0)
+            ;
+        CloseHandle(file);
+        *remaining -= size;
+        (*fileCount)++;
+    } while (*remaining > 0 && FindNextFile(find, &data));
+
+    FindClose(find);
+}
+
+// Prefetch the interpreter's directory (the one holding python.exe).
+static void prefetchInterpreter(Preflight *preflight)
+{
+    char directory[MAX_PATH];
+    strcpy(directory, preflight->pythonPath);
+    char *lastSlash = strrchr(directory, '\\');
+    if (!lastSlash)
+        strcpy(directory, ".");
+    else
+        *lastSlash = '\0';
+
+    char *buffer = (char *)malloc(PREFETCH_CHUNK_SIZE);
+    if (!buffer)
+        return;
+
+    DWORD startTick = GetTickCount();
+    ULONGLONG remaining = preflight->prefetchBytes;
+    DWORD fileCount = 0;
+    prefetchDirectory(directory, buffer, &remaining, &fileCount);
+    free(buffer);
+
+    printf("[INFO] Preflight: prefetched %lu interpreter files (%llu MB) in %lu ms.\n", fileCount,
+           (preflight->prefetchBytes - remaining) / (1024 * 1024), GetTickCount() - startTick);
+}
+
+// Preflight thread: compile in the background, prefetch meanwhile, then record the compile.
+static DWORD WINAPI preflightThread(LPVOID parameter)
+{
+    Preflight *preflight = (Preflight *)parameter;
+
+    // Background mode lowers the thread's I/O priority too, so Launcher.py's own reads go first
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    ULONGLONG newest = 0;
+    HANDLE compile = startCompile(preflight, &newest);
+    if (preflight->prefetchBytes)
+        prefetchInterpreter(preflight);
+
+    if (compile)
+    {
+        // Errors in a script are reported when it runs; the stamp still stops recompiling it
+        if (WaitForSingleObject(compile, PREFLIGHT_COMPILE_TIMEOUT_MS) == WAIT_OBJECT_0)
+            writeStamp(preflight->stampPath, newest);
+        CloseHandle(compile);
+    }
+
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    return 0;
+}
+
+// Start the preflight thread.
+BOOL startPreflight(Preflight *preflight, const char *pythonPath, const LauncherConfig *config)
+{
+    ZeroMemory(preflight, sizeof(*preflight));
+    if (strlen(pythonPath) >= sizeof(preflight->pythonPath) || strlen(config->preflightStampFile) >= MAX_PATH)
+        return FALSE;
+
+    strcpy(preflight->pythonPath, pythonPath);
+    strcpy(preflight->compileDirectories, config->preflightCompileDirs);
+    strcpy(preflight->stampPath, config->preflightStampFile);
+    preflight->prefetchBytes = (ULONGLONG)config->preflightPrefetchMb * 1024 * 1024;
+
+    preflight->thread = CreateThread(NULL, 0, preflightThread, preflight, 0, NULL);
+    return preflight->thread != NULL;
+}
+
+void closePreflight(Preflight *preflight)
+{
+    if (preflight->thread)
+        CloseHandle(preflight->thread);
+    preflight->thread = NULL;
+}
@@ -0,0 +1,33 @@
+#ifndef PREFLIGHT_H
+#define PREFLIGHT_H
+
+#include <windows.h>
+
+#include "Config.h"
+
+// Optional start-up work that makes Python's imports cheaper, done on a background thread
+// while the launcher sets up its console and pipes:
+//   - When any .py file under the compile directories is newer than the stamp file,
+//     "python -m compileall" is run on them at idle priority, so Launcher.py and the scripts
+//     find up-to-date bytecode instead of compiling on import. The stamp is written once it
+//     finishes.
+//   - The interpreter's zip, .pyc, .pyd and .dll files are read once with sequential scan
+//     (up to the prefetch budget), so the first launch after boot reads them from the file
+//     cache instead of the disk.
+typedef struct
+{
+    HANDLE thread;
+    char pythonPath[MAX_PATH];
+    char compileDirectories[CONFIG_STRING_SIZE]; // Separated by ';'
+    char stampPath[MAX_PATH];
+    ULONGLONG prefetchBytes;   // Budget, 0 disables prefetching
+} Preflight;
+
+// Start the preflight thread. Returns FALSE if it could not be started.
+BOOL startPreflight(Preflight *preflight, const char *pythonPath, const LauncherConfig *config);
+
+// Release the thread handle. A compile still running finishes on its own without writing the
+// stamp, so the next start runs it again over bytecode that is by then current.
+void closePreflight(Preflight *preflight);
+
+#endif // PREFLIGHT_H
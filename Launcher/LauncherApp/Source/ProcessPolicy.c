@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <string.h>
+#include "ProcessPolicy.h"
+
+// Power throttling definitions (newer than the TinyCC headers)
+#define POLICY_PROCESS_POWER_THROTTLING             4 // PROCESS_INFORMATION_CLASS value
+#define POLICY_POWER_THROTTLING_CURRENT_VERSION     1
+#define POLICY_POWER_THROTTLING_EXECUTION_SPEED     0x1
+
+typedef struct
+{
+    ULONG version;
+    ULONG controlMask;
+    ULONG stateMask;
+} PowerThrottlingState;
+
+typedef BOOL (WINAPI *SetProcessInformation_t)(HANDLE, int, LPVOID, DWORD);
+
+static SetProcessInformation_t g_setProcessInformation = NULL;
+
+// Translate a priority name into a priority class.
+BOOL parsePriorityClass(const char *name, DWORD *priorityClass)
+{
+    static const struct
+    {
+        const char *name;
+        DWORD priorityClass;
+    } classes[] = {
+        {"", 0},
+        {"idle", IDLE_PRIORITY_CLASS},
+        {"below_normal", BELOW_NORMAL_PRIORITY_CLASS},
+        {"normal", NORMAL_PRIORITY_CLASS},
+        {"above_normal", ABOVE_NORMAL_PRIORITY_CLASS},
+        {"high", HIGH_PRIORITY_CLASS},
+    };
+
+    for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++)
+    {
+        if (_stricmp(name, classes[i].name) == 0)
+        {
+            *priorityClass = classes[i].priorityClass;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Set the job's priority and affinity limits.
+BOOL initProcessPolicy(ProcessPolicy *policy, HANDLE job, DWORD priorityClass, ULONG_PTR affinityMask,
+                       BOOL ecoQos)
+{
+    ZeroMemory(policy, sizeof(*policy));
+    policy->job = job;
+    policy->priorityClass = priorityClass;
+    policy->ecoQos = ecoQos;
+
+    // The job can only use processors the system has
+    DWORD_PTR processMask, systemMask;
+    if (affinityMask && GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+    {
+        affinityMask &= systemMask;
+        if (!affinityMask)
+            printf("[WARNING] Affinity mask selects no available processor, ignoring it.\n");
+    }
+    policy->affinityMask = affinityMask;
+
+    if (ecoQos)
+    {
+        HMODULE kernel32 = GetModuleHandle("kernel32.dll");
+        g_setProcessInformation = (SetProcessInformation_t)GetProcAddress(kernel32, "SetProcessInformation");
+        if (!g_setProcessInformation)
+        {
+            printf("[WARNING] EcoQoS is not supported on this version of Windows.\n");
+            policy->ecoQos = FALSE;
+        }
+    }
+
+    if (!priorityClass && !policy->affinityMask)
+        return TRUE;
+
+    // Add to the existing limits (kill on close) rather than replacing them
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    if (!QueryInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits), NULL))
+        return FALSE;
+
+    if (priorityClass)
+    {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_PRIORITY_CLASS;
+        limits.BasicLimitInformation.PriorityClass = priorityClass;
+    }
+    if (policy->affinityMask)
+    {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_AFFINITY;
+        limits.BasicLimitInformation.Affinity = policy->affinityMask;
+    }
+    return SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+}
+
+// Opt one process into EcoQoS.
+static void applyEcoQos(DWORD pid)
+{
+    HANDLE process = OpenProcess(PROCESS_SET_INFORMATION, FALSE, pid);
+    if (!process)
+        return;
+
+    PowerThrottlingState state;
+    state.version = POLICY_POWER_THROTTLING_CURRENT_VERSION;
+    state.controlMask = POLICY_POWER_THROTTLING_EXECUTION_SPEED;
+    state.stateMask = POLICY_POWER_THROTTLING_EXECUTION_SPEED;
+    g_setProcessInformation(process, POLICY_PROCESS_POWER_THROTTLING, &state, sizeof(state));
+    CloseHandle(process);
+}
+
+// Apply EcoQoS to processes that joined the job since the last call.
+void applyProcessPolicy(ProcessPolicy *policy)
+{
+    if (!policy->ecoQos)
+        return;
+
+    struct
+    {
+        JOBOBJECT_BASIC_PROCESS_ID_LIST list;
+        ULONG_PTR more[POLICY_MAX_PROCESSES];
+    } pids;
+
+    ZeroMemory(&pids, sizeof(pids));
+    if (!QueryInformationJobObject(policy->job, JobObjectBasicProcessIdList, &pids, sizeof(pids), NULL) &&
+        GetLastError() != ERROR_MORE_DATA)
+        return;
+
+    DWORD pidCount = pids.list.NumberOfProcessIdsInList;
+    if (pidCount > POLICY_MAX_PROCESSES)
+        pidCount = POLICY_MAX_PROCESSES;
+
+    DWORD current[POLICY_MAX_PROCESSES];
+    for (DWORD i = 0; i < pidCount; i++)
+    {
+        DWORD pid = (DWORD)pids.list.ProcessIdList[i];
+        BOOL known = FALSE;
+        for (DWORD j = 0; j < policy->knownCount && !known; j++)
+            known = policy->knownPids[j] == pid;
+
+        if (!known)
+            applyEcoQos(pid);
+        current[i] = pid;
+    }
+
+    // Forget exited processes so a reused PID is handled again
+    memcpy(policy->knownPids, current, pidCount * sizeof(DWORD));
+    policy->knownCount = pidCount;
+}
@@ -0,0 +1,33 @@
+#ifndef PROCESS_POLICY_H
+#define PROCESS_POLICY_H
+
+#include <windows.h>
+
+// Most processes whose EcoQoS state is remembered between passes
+#define POLICY_MAX_PROCESSES 64
+
+// Scheduling policy for the Python tree. Priority class and affinity are job limits, so every
+// process in the job (Launcher.py, its scripts and their children) inherits them. EcoQoS is a
+// per-process setting and is applied to each new process found in the job.
+typedef struct
+{
+    HANDLE job;
+    DWORD priorityClass;       // 0 leaves the priority alone
+    ULONG_PTR affinityMask;    // 0 leaves the affinity alone
+    BOOL ecoQos;               // Opt processes into power throttling (EcoQoS)
+    DWORD knownPids[POLICY_MAX_PROCESSES]; // Processes already handled
+    DWORD knownCount;
+} ProcessPolicy;
+
+// Translate "idle", "below_normal", "normal", "above_normal" or "high" into a priority class.
+// An empty name gives 0 (inherit). Returns FALSE for an unknown name.
+BOOL parsePriorityClass(const char *name, DWORD *priorityClass);
+
+// Set the job's priority and affinity limits. Returns FALSE if the job rejected them.
+BOOL initProcessPolicy(ProcessPolicy *policy, HANDLE job, DWORD priorityClass, ULONG_PTR affinityMask,
+                       BOOL ecoQos);
+
+// Apply EcoQoS to processes that joined the job since the last call. Cheap when nothing changed.
+void applyProcessPolicy(ProcessPolicy *policy);
+
+#endif // PROCESS_POLICY_H
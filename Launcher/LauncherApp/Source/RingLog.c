@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <time.h>
+#include "RingLog.h"
+
+// Open or create the log file and map it.
+BOOL openRingLog(RingLog *log, const char *path, DWORD sizeBytes)
+{
+    ZeroMemory(log, sizeof(*log));
+
+    DWORD totalSize = sizeof(RingLogHeader) + sizeBytes;
+    log->file = CreateFile(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL, NULL);
+    if (log->file == INVALID_HANDLE_VALUE)
+    {
+        log->file = NULL;
+        return FALSE;
+    }
+
+    // Mapping at the full size extends a new (or differently sized) file as needed
+    log->mapping = CreateFileMapping(log->file, NULL, PAGE_READWRITE, 0, totalSize, NULL);
+    if (log->mapping)
+        log->header = (RingLogHeader *)MapViewOfFile(log->mapping, FILE_MAP_ALL_ACCESS, 0, 0, totalSize);
+    if (!log->header)
+    {
+        closeRingLog(log);
+        return FALSE;
+    }
+    log->data = (char *)log->header + sizeof(RingLogHeader);
+
+    RingLogHeader *header = log->header;
+    if (header->magic != RING_LOG_MAGIC || header->version != RING_LOG_VERSION ||
+        header->headerSize != sizeof(RingLogHeader) || header->dataSize != sizeBytes)
+    {
+        // New file or a layout we do not understand: start over
+        ZeroMemory(header, sizeof(*header));
+        header->version = RING_LOG_VERSION;
+        header->headerSize = sizeof(RingLogHeader);
+        header->dataSize = sizeBytes;
+        header->magic = RING_LOG_MAGIC;
+    }
+    header->sessionCount++;
+    header->launcherPid = GetCurrentProcessId();
+
+    // Mark where this run starts so sessions can be told apart when reading the file
+    char marker[128];
+    time_t now = time(NULL);
+    int length = snprintf(marker, sizeof(marker), "\n===== MSFS-PyScriptManager session %lu, pid %lu, %s",
+                          header->sessionCount, header->launcherPid, ctime(&now));
+    if (length > 0 && length < (int)sizeof(marker))
+        ringLogWrite(log, marker, (DWORD)length);
+
+    return TRUE;
+}
+
+// Append data to the ring.
+void ringLogWrite(RingLog *log, const char *data, DWORD length)
+{
+    RingLogHeader *header = log->header;
+    DWORD size = header->dataSize;
+
+    // Only the newest dataSize bytes can be kept
+    if (length > size)
+    {
+        data += length - size;
+        header->writeOffset += length - size;
+        header->wrapCount++;
+        length = size;
+    }
+
+    DWORD offset = (DWORD)(header->writeOffset % size);
+    DWORD firstPart = size - offset;
+    if (firstPart > length)
+        firstPart = length;
+
+    CopyMemory(log->data + offset, data, firstPart);
+    CopyMemory(log->data, data + firstPart, length - firstPart);
+    if (offset + length >= size)
+        header->wrapCount++;
+
+    MemoryBarrier();
+    header->writeOffset += length; // Published after the data for readers of the live file
+}
+
+// Unmap and close the file.
+void closeRingLog(RingLog *log)
+{
+    if (log->header)
+        UnmapViewOfFile(log->header);
+    if (log->mapping)
+        CloseHandle(log->mapping);
+    if (log->file)
+        CloseHandle(log->file);
+    ZeroMemory(log, sizeof(*log));
+}
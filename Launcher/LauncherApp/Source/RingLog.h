@@ -0,0 +1,46 @@
+#ifndef RING_LOG_H
+#define RING_LOG_H
+
+#include <windows.h>
+
+// Fixed-size log file used as a ring through a memory mapping. Writes are plain memory copies,
+// the system writes dirty pages back lazily, so teeing output costs no syscalls per line and
+// the file survives a crash of the launcher or of Launcher.py.
+//
+// File layout: RingLogHeader followed by dataSize bytes of ring. The oldest byte is at
+// writeOffset % dataSize once wrapCount is non-zero; before that the data starts at 0.
+
+#define RING_LOG_MAGIC   0x4C52534D // "MSRL"
+#define RING_LOG_VERSION 1
+
+typedef struct
+{
+    DWORD magic;                 // RING_LOG_MAGIC
+    DWORD version;               // RING_LOG_VERSION
+    DWORD headerSize;            // sizeof(RingLogHeader), data follows
+    DWORD dataSize;              // Ring size in bytes
+    volatile ULONGLONG writeOffset; // Total bytes ever written (position = writeOffset % dataSize)
+    ULONGLONG wrapCount;         // Times the ring has wrapped
+    DWORD sessionCount;          // Launcher runs that have appended to this file
+    DWORD launcherPid;           // Process ID of the last writer
+} RingLogHeader;
+
+typedef struct
+{
+    HANDLE file;
+    HANDLE mapping;
+    RingLogHeader *header;       // Start of the mapped view
+    char *data;                  // Ring storage (after the header)
+} RingLog;
+
+// Open or create the log file with a ring of sizeBytes. An existing file of the same size keeps
+// its contents and continues where it stopped. Returns FALSE if the file cannot be mapped.
+BOOL openRingLog(RingLog *log, const char *path, DWORD sizeBytes);
+
+// Append data to the ring, overwriting the oldest bytes once full.
+void ringLogWrite(RingLog *log, const char *data, DWORD length);
+
+// Unmap and close the file. Dirty pages are flushed by the system.
+void closeRingLog(RingLog *log);
+
+#endif // RING_LOG_H
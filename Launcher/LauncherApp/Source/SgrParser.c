@@ -0,0 +1,159 @@
+#include <string.h>
+#include "SgrParser.h"
+
+#define SGR_STATE_TEXT     0
+#define SGR_STATE_ESCAPE   1 // After ESC
+#define SGR_STATE_SEQUENCE 2 // After ESC [
+
+#define SGR_ESCAPE 0x1B
+
+// Largest parameter value kept, larger values cannot be valid codes
+#define SGR_PARAM_LIMIT 9999
+
+void initSgrParser(SgrParser *parser)
+{
+    ZeroMemory(parser, sizeof(*parser));
+}
+
+// Apply the parameters of a complete SGR sequence to the current style.
+static void applySgr(SgrParser *parser)
+{
+    for (DWORD i = 0; i < parser->paramCount; i++)
+    {
+        DWORD code = parser->params[i];
+        if (code == 0)
+            parser->style = 0; // ESC[m and ESC[0m both reset
+        else if (code == 1)
+            parser->style |= SGR_STYLE_BOLD;
+        else if (code == 22)
+            parser->style &= ~SGR_STYLE_BOLD;
+        else if (code >= 30 && code <= 37)
+            parser->style = (BYTE)((parser->style & ~SGR_STYLE_COLOR_MASK) | (code - 29));
+        else if (code == 39)
+            parser->style &= ~SGR_STYLE_COLOR_MASK;
+    }
+}
+
+// Handle one byte of a control sequence. Returns FALSE if the byte cannot be part of one; the
+// sequence is abandoned and the byte is left to be parsed as text.
+static BOOL parseSequenceByte(SgrParser *parser, BYTE c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        parser->param = parser->param * 10 + (c - '0');
+        if (parser->param > SGR_PARAM_LIMIT)
+            parser->param = SGR_PARAM_LIMIT;
+    }
+    else if (c == ';')
+    {
+        if (parser->paramCount < SGR_MAX_PARAMS)
+            parser->params[parser->paramCount++] = parser->param;
+        parser->param = 0;
+    }
+    else if (c >= 0x40 && c <= 0x7E)
+    {
+        // Final byte: only "m" without private bytes changes the style
+        if (parser->paramCount < SGR_MAX_PARAMS)
+            parser->params[parser->paramCount++] = parser->param;
+        if (c == 'm' && !parser->privateSequence)
+            applySgr(parser);
+        parser->state = SGR_STATE_TEXT;
+    }
+    else if (c >= 0x20 && c <= 0x3F)
+    {
+        parser->privateSequence = TRUE; // "?", ">", intermediates and so on
+    }
+    else
+    {
+        parser->state = SGR_STATE_TEXT; // Not a valid sequence, abandon it
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Parse input into text and style runs.
+DWORD sgrParse(SgrParser *parser, const char *input, DWORD length, char *text, DWORD textSize,
+               DWORD *textLength, SgrRun *runs, DWORD maxRuns, DWORD *runCount)
+{
+    DWORD position = 0;
+    *textLength = 0;
+    *runCount = 0;
+
+    while (position < length)
+    {
+        if (parser->state != SGR_STATE_TEXT)
+        {
+            // A byte that ends a sequence by not belonging to it (a newline, another ESC, UTF-8)
+            // is not consumed, so it goes on as text
+            BYTE c = (BYTE)input[position];
+            if (parser->state == SGR_STATE_SEQUENCE)
+            {
+                if (parseSequenceByte(parser, c))
+                    position++;
+            }
+            else if (c == '[')
+            {
+                parser->state = SGR_STATE_SEQUENCE;
+                parser->privateSequence = FALSE;
+                parser->paramCount = 0;
+                parser->param = 0;
+                position++;
+            }
+            else
+            {
+                parser->state = SGR_STATE_TEXT;
+                if (c >= 0x20 && c <= 0x7E)
+                    position++; // Two-byte escape, dropped
+            }
+            continue;
+        }
+
+        // Copy the plain text up to the next escape in one go
+        const char *escape = (const char *)memchr(input + position, SGR_ESCAPE, length - position);
+        DWORD span = escape ? (DWORD)(escape - input) - position : length - position;
+        if (span == 0)
+        {
+            parser->state = SGR_STATE_ESCAPE;
+            position++;
+            continue;
+        }
+
+        DWORD room = textSize - *textLength;
+        if (room == 0)
+            break;
+        if (span > room)
+            span = room;
+
+        // Text in the same style as the last run extends it
+        SgrRun *run = *runCount ? &runs[*runCount - 1] : NULL;
+        if (!run || run->style != parser->style)
+        {
+            if (*runCount == maxRuns)
+                break;
+            run = &runs[(*runCount)++];
+            run->offset = (WORD)*textLength;
+            run->length = 0;
+            run->style = parser->style;
+        }
+
+        memcpy(text + *textLength, input + position, span);
+        *textLength += span;
+        run->length = (WORD)(run->length + span);
+        position += span;
+    }
+    return position;
+}
+
+// Serialize runs for the wire.
+void sgrWriteRuns(const SgrRun *runs, DWORD runCount, BYTE *output)
+{
+    for (DWORD i = 0; i < runCount; i++)
+    {
+        output[0] = (BYTE)(runs[i].offset & 0xFF);
+        output[1] = (BYTE)(runs[i].offset >> 8);
+        output[2] = (BYTE)(runs[i].length & 0xFF);
+        output[3] = (BYTE)(runs[i].length >> 8);
+        output[4] = runs[i].style;
+        output += SGR_RUN_SIZE;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SGR_PARSER_H
+#define SGR_PARSER_H
+
+#include <windows.h>
+
+// Style IDs: the low nibble is the foreground color (0 default, 1-8 for SGR 30-37), bit 4 is
+// bold. parse_ansi.py's style_from_id mirrors this.
+#define SGR_STYLE_COLOR_MASK 0x0F
+#define SGR_STYLE_BOLD       0x10
+
+// Most parameters of one escape sequence that are applied; extra ones are ignored
+#define SGR_MAX_PARAMS 16
+
+// A span of parsed text in one style
+typedef struct
+{
+    WORD offset;                // Into the parsed text
+    WORD length;
+    BYTE style;                 // Style ID
+} SgrRun;
+
+// Bytes of one serialized run: offset and length (WORD, little endian), then the style ID
+#define SGR_RUN_SIZE 5
+
+// Splits output into plain text and style runs, so Launcher.py can insert each run with one
+// tagged insert instead of parsing escape codes on the Tk thread. Handles SGR sequences
+// (ESC [ ... m) for reset, bold and the 8 basic foreground colors; other control sequences
+// are removed. Sequences split across calls are completed on the next call.
+typedef struct
+{
+    BYTE style;                 // Style of the text that follows
+    BYTE state;                 // Text, after ESC, or inside a control sequence
+    BOOL privateSequence;       // Sequence has intermediate or private bytes, never an SGR
+    DWORD params[SGR_MAX_PARAMS];
+    DWORD paramCount;
+    DWORD param;                // Parameter being read
+} SgrParser;
+
+void initSgrParser(SgrParser *parser);
+
+// Parse input into text (escape codes removed) and its runs. Stops early when text or runs are
+// full. Returns the number of input bytes consumed; call again with the rest.
+DWORD sgrParse(SgrParser *parser, const char *input, DWORD length, char *text, DWORD textSize,
+               DWORD *textLength, SgrRun *runs, DWORD maxRuns, DWORD *runCount);
+
+// Serialize runs for the wire. output needs runCount * SGR_RUN_SIZE bytes.
+void sgrWriteRuns(const SgrRun *runs, DWORD runCount, BYTE *output);
+
+#endif // SGR_PARSER_H
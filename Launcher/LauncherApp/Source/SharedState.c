@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include "SharedState.h"
+
+// Create the named section and map it.
+SharedState *createSharedState(DWORD pid, int randomSuffix, DWORD heartbeatIntervalMs,
+                               char *nameBuffer, size_t nameBufferSize, HANDLE *mapping)
+{
+    snprintf(nameBuffer, nameBufferSize, "Local\\MSFSPyScriptManagerState_%lu_%d", pid, randomSuffix);
+
+    *mapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SharedState), nameBuffer);
+    if (!*mapping)
+        return NULL;
+
+    SharedState *state = (SharedState *)MapViewOfFile(*mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedState));
+    if (!state)
+    {
+        CloseHandle(*mapping);
+        *mapping = NULL;
+        return NULL;
+    }
+
+    // Fresh sections are zero-filled, only the header needs setting
+    state->version = SHARED_STATE_VERSION;
+    state->size = sizeof(SharedState);
+    state->heartbeatIntervalMs = heartbeatIntervalMs;
+    state->launcherPid = GetCurrentProcessId();
+    MemoryBarrier();
+    state->magic = SHARED_STATE_MAGIC; // Written last so readers never see a partial header
+
+    return state;
+}
+
+// Publish new job accounting totals to the shared block.
+void publishJobAccounting(SharedState *state, const JobAccounting *accounting)
+{
+    InterlockedIncrement(&state->accountingSequence); // Odd: update in progress
+    MemoryBarrier();
+    state->jobAccounting = *accounting;
+    MemoryBarrier();
+    InterlockedIncrement(&state->accountingSequence); // Even: update complete
+}
+
+// Unmap the view and close the section handle.
+void closeSharedState(SharedState *state, HANDLE mapping)
+{
+    if (state)
+        UnmapViewOfFile(state);
+    if (mapping)
+        CloseHandle(mapping);
+}
@@ -0,0 +1,66 @@
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <windows.h>
+#include "JobObject.h"
+#include "Telemetry.h"
+#include "InterpreterPool.h"
+
+// Named shared-memory block that replaces the text heartbeat on the command pipe.
+// The launcher increments the heartbeat counter on every heartbeat tick and sets the shutdown
+// flag when the console is closed; Launcher.py checks both with a plain memory read.
+//
+// The layout is mirrored in Launcher/LauncherScript/launcher_state.py - keep them in sync.
+// New fields are only ever appended and SHARED_STATE_VERSION bumped.
+
+#define SHARED_STATE_MAGIC   0x5350534D // "MSPS"
+#define SHARED_STATE_VERSION 7
+
+typedef struct
+{
+    DWORD magic;                     // SHARED_STATE_MAGIC
+    DWORD version;                   // SHARED_STATE_VERSION
+    DWORD size;                      // sizeof(SharedState)
+    volatile LONG heartbeat;         // Incremented by the launcher every heartbeat interval
+    volatile LONG shutdownRequested; // Non-zero once the launcher wants the UI to shut down
+    DWORD heartbeatIntervalMs;       // Interval between heartbeat increments
+    DWORD launcherPid;               // Process ID of the launcher exe
+
+    // Version 2: job object accounting for the whole Python tree, refreshed every heartbeat.
+    // accountingSequence is odd while the launcher is writing; readers retry until they see
+    // the same even value before and after copying the block.
+    volatile LONG accountingSequence;
+    JobAccounting jobAccounting;
+
+    // Version 3: per-process CPU and memory telemetry for every process in the job
+    TelemetryTable telemetry;
+
+    // Version 4: pre-started interpreters Launcher.py can hand scripts to
+    PoolTable pool;
+
+    // Version 5: start-up profiling marks written by Launcher.py as raw QueryPerformanceCounter
+    // values (0 until reached). Only used with --profile-startup.
+    volatile LONGLONG uiMainQpc;       // Launcher.py finished its imports and entered main
+    volatile LONGLONG uiFirstFrameQpc; // First Tk frame has been drawn
+
+    // Version 6: incremented by Launcher.py from its Tk loop; a stalled counter means a hung UI
+    volatile LONG uiHeartbeat;
+    DWORD reserved6;
+
+    // Version 7: event Launcher.py sets once its shutdown is complete, so the console handler
+    // can stop waiting before its deadline
+    char shutdownAckEventName[64];
+} SharedState;
+
+// Create the named section and map it. The name is written to nameBuffer so it can be passed
+// to the Python side. Returns NULL on failure; *mapping receives the section handle.
+SharedState *createSharedState(DWORD pid, int randomSuffix, DWORD heartbeatIntervalMs,
+                               char *nameBuffer, size_t nameBufferSize, HANDLE *mapping);
+
+// Publish new job accounting totals to the shared block.
+void publishJobAccounting(SharedState *state, const JobAccounting *accounting);
+
+// Unmap the view and close the section handle.
+void closeSharedState(SharedState *state, HANDLE mapping);
+
+#endif // SHARED_STATE_H
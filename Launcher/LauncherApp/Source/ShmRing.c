@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <string.h>
+#include "ShmRing.h"
+
+// Create the named mapping and event.
+BOOL createShmRing(ShmRing *ring, DWORD pid, int randomSuffix, DWORD capacity, char *nameBuffer,
+                   size_t nameBufferSize)
+{
+    ZeroMemory(ring, sizeof(*ring));
+    InitializeCriticalSection(&ring->writeLock);
+    ring->lockReady = TRUE;
+
+    // Power of two, so a position maps to an offset with a mask
+    DWORD size = SHM_RING_MIN_CAPACITY;
+    while (size < capacity && size < SHM_RING_MAX_CAPACITY)
+        size <<= 1;
+
+    snprintf(nameBuffer, nameBufferSize, "Local\\MSFSPyScriptManagerRing_%lu_%d", pid, randomSuffix);
+    ring->mapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0,
+                                      sizeof(ShmRingHeader) + size, nameBuffer);
+    if (!ring->mapping)
+        return FALSE;
+
+    ring->header = (ShmRingHeader *)MapViewOfFile(ring->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!ring->header)
+    {
+        closeShmRing(ring);
+        return FALSE;
+    }
+
+    // Auto-reset: one wakeup per sleep of the reader
+    snprintf(ring->header->eventName, sizeof(ring->header->eventName), "Local\\MSFSPyScriptManagerRingWake_%lu_%d",
+             pid, randomSuffix);
+    ring->event = CreateEvent(NULL, FALSE, FALSE, ring->header->eventName);
+    if (!ring->event)
+    {
+        closeShmRing(ring);
+        return FALSE;
+    }
+
+    // Fresh sections are zero-filled, only the header needs setting
+    ring->data = (BYTE *)ring->header + sizeof(ShmRingHeader);
+    ring->capacity = size;
+    ring->header->version = SHM_RING_VERSION;
+    ring->header->capacity = size;
+    ring->header->headerSize = sizeof(ShmRingHeader);
+    MemoryBarrier();
+    ring->header->magic = SHM_RING_MAGIC; // Written last so readers never see a partial header
+    return TRUE;
+}
+
+// Copy bytes into the data area at a position, wrapping around its end.
+static void copyIn(ShmRing *ring, LONGLONG position, const void *source, DWORD length)
+{
+    DWORD offset = (DWORD)(position & (ring->capacity - 1));
+    DWORD first = ring->capacity - offset;
+    if (first > length)
+        first = length;
+
+    memcpy(ring->data + offset, source, first);
+    memcpy(ring->data, (const BYTE *)source + first, length - first);
+}
+
+// Append one record.
+BOOL shmRingWrite(ShmRing *ring, const void *payload, DWORD length, DWORD timeoutMs)
+{
+    DWORD recordSize = (sizeof(DWORD) + length + 3) & ~3u;
+    if (recordSize > ring->capacity)
+    {
+        ring->dropped++;
+        return FALSE;
+    }
+
+    EnterCriticalSection(&ring->writeLock);
+
+    // Wait for the reader to free enough space; only a stalled UI gets here
+    DWORD startTick = GetTickCount();
+    for (;;)
+    {
+        LONGLONG readPos = ring->header->readPos;
+        MemoryBarrier(); // Read the position before reusing the space it frees
+        if (ring->capacity - (ring->writePos - readPos) >= recordSize)
+            break;
+        if (GetTickCount() - startTick >= timeoutMs)
+        {
+            ring->dropped++;
+            LeaveCriticalSection(&ring->writeLock);
+            return FALSE;
+        }
+        Sleep(1);
+    }
+
+    copyIn(ring, ring->writePos, &length, sizeof(length));
+    copyIn(ring, ring->writePos + sizeof(DWORD), payload, length);
+    ring->writePos += recordSize;
+
+    MemoryBarrier(); // The record is complete before its position is published
+    ring->header->writePos = ring->writePos;
+    MemoryBarrier(); // Publish before checking whether the reader sleeps
+
+    if (ring->header->consumerWaiting)
+    {
+        ring->header->consumerWaiting = 0;
+        SetEvent(ring->event);
+    }
+    LeaveCriticalSection(&ring->writeLock);
+    return TRUE;
+}
+
+// Unmap the ring and close its handles.
+void closeShmRing(ShmRing *ring)
+{
+    if (ring->header)
+        UnmapViewOfFile(ring->header);
+    if (ring->mapping)
+        CloseHandle(ring->mapping);
+    if (ring->event)
+        CloseHandle(ring->event);
+    if (ring->lockReady)
+        DeleteCriticalSection(&ring->writeLock);
+    ZeroMemory(ring, sizeof(*ring));
+}
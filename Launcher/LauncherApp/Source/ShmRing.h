@@ -0,0 +1,67 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <windows.h>
+
+// Single-producer/single-consumer ring of length-prefixed records in a named file mapping.
+// The launcher writes, Launcher.py reads straight out of the mapping, so a record costs no
+// pipe syscall on either side. Writer threads inside the launcher take writeLock, so the
+// mapping itself only ever sees one producer.
+//
+// Positions are byte counts that only grow; the record at a position starts at
+// (position % capacity). Each record is a DWORD length and its payload, padded to 4 bytes,
+// and may wrap around the end of the data area.
+//
+// The event is only for wakeups: the reader sets consumerWaiting before it sleeps, and the
+// writer signals the event when it sees the flag after publishing a record.
+//
+// The layout is mirrored in Launcher/LauncherScript/shm_ring.py - keep them in sync.
+
+#define SHM_RING_MAGIC   0x474E5253 // "SRNG"
+#define SHM_RING_VERSION 1
+
+#define SHM_RING_MIN_CAPACITY (64 * 1024)
+#define SHM_RING_MAX_CAPACITY (64 * 1024 * 1024)
+
+// Header at the start of the mapping; the positions sit on their own cache lines
+typedef struct
+{
+    DWORD magic;                    // SHM_RING_MAGIC, written last
+    DWORD version;                  // SHM_RING_VERSION
+    DWORD capacity;                 // Size of the data area, a power of two
+    DWORD headerSize;               // Offset of the data area, sizeof(ShmRingHeader)
+    char eventName[64];             // Wakeup event of the reader
+    BYTE reserved0[48];
+    volatile LONGLONG writePos;     // Offset 128: end of the published records (writer only)
+    BYTE reserved1[56];
+    volatile LONGLONG readPos;      // Offset 192: end of the consumed records (reader only)
+    volatile LONG consumerWaiting;  // Non-zero while the reader sleeps on the event
+    BYTE reserved2[52];
+} ShmRingHeader;
+
+typedef struct
+{
+    HANDLE mapping;
+    HANDLE event;
+    ShmRingHeader *header;
+    BYTE *data;
+    DWORD capacity;
+    LONGLONG writePos;              // Writer's copy of header->writePos
+    CRITICAL_SECTION writeLock;     // Held while a record is written
+    BOOL lockReady;
+    DWORD dropped;                  // Records dropped because the reader fell too far behind
+} ShmRing;
+
+// Create the named mapping and event. capacity is rounded up to a power of two within
+// SHM_RING_MIN_CAPACITY..SHM_RING_MAX_CAPACITY. The mapping name is written to nameBuffer.
+BOOL createShmRing(ShmRing *ring, DWORD pid, int randomSuffix, DWORD capacity, char *nameBuffer,
+                   size_t nameBufferSize);
+
+// Append one record, waiting up to timeoutMs for the reader to free space. Returns FALSE if
+// the record was dropped.
+BOOL shmRingWrite(ShmRing *ring, const void *payload, DWORD length, DWORD timeoutMs);
+
+// Unmap the ring and close its handles.
+void closeShmRing(ShmRing *ring);
+
+#endif // SHM_RING_H
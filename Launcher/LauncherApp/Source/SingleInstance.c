@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <string.h>
+#include "SingleInstance.h"
+
+// Pipe flags newer than the TinyCC headers
+#ifndef PIPE_REJECT_REMOTE_CLIENTS
+#define PIPE_REJECT_REMOTE_CLIENTS 0x00000008
+#endif
+#ifndef FILE_FLAG_FIRST_PIPE_INSTANCE
+#define FILE_FLAG_FIRST_PIPE_INSTANCE 0x00080000
+#endif
+
+// Longest wait for a client to send its request, or for the reply to be written
+#define ATTACH_IO_TIMEOUT_MS 2000
+
+// Longest wait of a second start for the running launcher to accept its request
+#define ATTACH_CONNECT_TIMEOUT_MS 5000
+
+// Build the mutex and pipe names, which include the session so fast user switching keeps
+// one launcher per user.
+static void initInstanceNames(SingleInstance *instance)
+{
+    DWORD session = 0;
+    ProcessIdToSessionId(GetCurrentProcessId(), &session);
+    snprintf(instance->mutexName, sizeof(instance->mutexName), "Local\\MSFS-PyScriptManager_%lu", session);
+    snprintf(instance->pipeName, sizeof(instance->pipeName), "\\\\.\\pipe\\MSFS-PyScriptManager_attach_%lu", session);
+}
+
+BOOL acquireSingleInstance(SingleInstance *instance)
+{
+    ZeroMemory(instance, sizeof(*instance));
+    initInstanceNames(instance);
+
+    instance->mutex = CreateMutex(NULL, FALSE, instance->mutexName);
+    if (!instance->mutex)
+    {
+        // Without the mutex this start cannot tell; run rather than refuse to start
+        printf("[WARNING] Failed to create the single-instance mutex. Error: %lu\n", GetLastError());
+        return TRUE;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        CloseHandle(instance->mutex);
+        instance->mutex = NULL;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Wait for an overlapped pipe operation. Returns FALSE on failure, timeout or stop, with the
+// operation cancelled.
+static BOOL waitAttachIo(HANDLE pipe, OVERLAPPED *overlapped, BOOL started, HANDLE stopEvent, DWORD timeoutMs,
+                         DWORD *transferred)
+{
+    if (!started && GetLastError() != ERROR_IO_PENDING)
+        return FALSE;
+
+    HANDLE handles[2] = {overlapped->hEvent, stopEvent};
+    if (WaitForMultipleObjects(2, handles, FALSE, timeoutMs) != WAIT_OBJECT_0)
+    {
+        CancelIo(pipe);
+        GetOverlappedResult(pipe, overlapped, transferred, TRUE);
+        return FALSE;
+    }
+    return GetOverlappedResult(pipe, overlapped, transferred, FALSE);
+}
+
+// Thread body: serve one attach client at a time until the stop event is set.
+static DWORD WINAPI attachServerThread(LPVOID parameter)
+{
+    SingleInstance *instance = (SingleInstance *)parameter;
+    OVERLAPPED overlapped = {0};
+    char request[ATTACH_REQUEST_SIZE];
+
+    overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!overlapped.hEvent)
+        return 1;
+
+    while (WaitForSingleObject(instance->stopEvent, 0) != WAIT_OBJECT_0)
+    {
+        // Only this process may create the pipe, so another program cannot pose as the launcher
+        HANDLE pipe = CreateNamedPipe(instance->pipeName,
+                                      PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                      PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                      1, ATTACH_REQUEST_SIZE, ATTACH_REQUEST_SIZE, 0, NULL);
+        if (pipe == INVALID_HANDLE_VALUE)
+        {
+            printf("[WARNING] Failed to create the attach pipe. Error: %lu\n", GetLastError());
+            break;
+        }
+
+        DWORD transferred = 0;
+        ResetEvent(overlapped.hEvent);
+        BOOL connected = ConnectNamedPipe(pipe, &overlapped);
+        if (!connected && GetLastError() == ERROR_PIPE_CONNECTED)
+            connected = TRUE;
+        else if (!connected)
+            connected = waitAttachIo(pipe, &overlapped, FALSE, instance->stopEvent, INFINITE, &transferred);
+
+        if (connected)
+        {
+            ResetEvent(overlapped.hEvent);
+            BOOL started = ReadFile(pipe, request, sizeof(request) - 1, NULL, &overlapped);
+            if (waitAttachIo(pipe, &overlapped, started, instance->stopEvent, ATTACH_IO_TIMEOUT_MS, &transferred))
+            {
+                request[transferred] = '\0';
+                const char *reply = instance->onRequest(request) ? "ok" : "busy";
+
+                ResetEvent(overlapped.hEvent);
+                started = WriteFile(pipe, reply, (DWORD)strlen(reply), NULL, &overlapped);
+                waitAttachIo(pipe, &overlapped, started, instance->stopEvent, ATTACH_IO_TIMEOUT_MS, &transferred);
+            }
+            DisconnectNamedPipe(pipe);
+        }
+        CloseHandle(pipe);
+    }
+
+    CloseHandle(overlapped.hEvent);
+    return 0;
+}
+
+BOOL startAttachServer(SingleInstance *instance, AttachRequestFn onRequest)
+{
+    instance->onRequest = onRequest;
+    instance->stopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!instance->stopEvent)
+        return FALSE;
+
+    instance->thread = CreateThread(NULL, 0, attachServerThread, instance, 0, NULL);
+    return instance->thread != NULL;
+}
+
+BOOL sendAttachRequest(SingleInstance *instance, const char *request)
+{
+    DWORD startTick = GetTickCount();
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+
+    // The pipe is missing while the running launcher starts up and busy while it serves
+    // another client, so retry until the deadline
+    while (GetTickCount() - startTick < ATTACH_CONNECT_TIMEOUT_MS)
+    {
+        pipe = CreateFile(instance->pipeName, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        if (pipe != INVALID_HANDLE_VALUE)
+            break;
+
+        DWORD error = GetLastError();
+        if (error == ERROR_PIPE_BUSY)
+            WaitNamedPipe(instance->pipeName, 100);
+        else if (error == ERROR_FILE_NOT_FOUND)
+            Sleep(50);
+        else
+            break;
+    }
+    if (pipe == INVALID_HANDLE_VALUE)
+    {
+        printf("[ERROR] Could not reach the running launcher. Error: %lu\n", GetLastError());
+        return FALSE;
+    }
+
+    DWORD mode = PIPE_READMODE_MESSAGE;
+    char reply[16] = {0};
+    DWORD transferred = 0;
+    BOOL accepted = SetNamedPipeHandleState(pipe, &mode, NULL, NULL) &&
+                    WriteFile(pipe, request, (DWORD)strlen(request), &transferred, NULL) &&
+                    ReadFile(pipe, reply, sizeof(reply) - 1, &transferred, NULL) &&
+                    strcmp(reply, "ok") == 0;
+    CloseHandle(pipe);
+
+    if (!accepted)
+        printf("[ERROR] The running launcher did not accept the request (%s).\n", reply[0] ? reply : "no reply");
+    return accepted;
+}
+
+void closeSingleInstance(SingleInstance *instance)
+{
+    if (instance->thread)
+    {
+        SetEvent(instance->stopEvent);
+        WaitForSingleObject(instance->thread, ATTACH_IO_TIMEOUT_MS);
+        CloseHandle(instance->thread);
+    }
+    if (instance->stopEvent)
+        CloseHandle(instance->stopEvent);
+    if (instance->mutex)
+        CloseHandle(instance->mutex);
+    ZeroMemory(instance, sizeof(*instance));
+}
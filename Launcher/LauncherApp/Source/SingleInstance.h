@@ -0,0 +1,42 @@
+#ifndef SINGLE_INSTANCE_H
+#define SINGLE_INSTANCE_H
+
+#include <windows.h>
+
+// Largest attach request, "group <path>" included
+#define ATTACH_REQUEST_SIZE 1024
+
+// One launcher per user session. The first launcher holds a named mutex and serves an attach
+// pipe; a second start finds the mutex, sends its request over the pipe and exits instead of
+// starting another Launcher.py and script set. Requests are single messages:
+//   focus         bring the launcher window to the front
+//   group <path>  load a .script_group file (absolute path, UTF-8) and bring the window to
+//                 the front
+// The running launcher hands them to Launcher.py as "attach <request>" commands and answers
+// "ok", or "busy" while Launcher.py is not connected. A first start sends its own group to
+// Launcher.py the same way once it has connected.
+typedef BOOL (*AttachRequestFn)(const char *request);
+
+typedef struct
+{
+    HANDLE mutex;
+    HANDLE stopEvent;           // Stops the attach server
+    HANDLE thread;              // Attach server thread
+    AttachRequestFn onRequest;
+    char mutexName[64];
+    char pipeName[64];
+} SingleInstance;
+
+// Take the session's launcher mutex. Returns FALSE if another launcher already holds it.
+BOOL acquireSingleInstance(SingleInstance *instance);
+
+// Serve the attach pipe on a background thread, calling onRequest for each request.
+BOOL startAttachServer(SingleInstance *instance, AttachRequestFn onRequest);
+
+// Send a request to the launcher holding the mutex. Returns TRUE once it accepted it.
+BOOL sendAttachRequest(SingleInstance *instance, const char *request);
+
+// Stop the attach server and release the mutex.
+void closeSingleInstance(SingleInstance *instance);
+
+#endif // SINGLE_INSTANCE_H
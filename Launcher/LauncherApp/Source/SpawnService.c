@@ -0,0 +1,778 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SpawnService.h"
+#include "JobObject.h"
+
+// Completion keys telling the service thread what a packet is
+#define SPAWN_KEY_READ    1 // Read on a script's stdout or stderr (overlapped is a SpawnStream)
+#define SPAWN_KEY_WRITE   2 // Write to a script's stdin (overlapped is a SpawnWrite)
+#define SPAWN_KEY_REQUEST 3 // input/close/kill request (overlapped is a SpawnRequest)
+#define SPAWN_KEY_ADD     4 // A script was started (overlapped is its SpawnChild)
+#define SPAWN_KEY_EXIT    5 // A script exited (overlapped is its SpawnChild)
+#define SPAWN_KEY_STOP    6 // closeSpawnService was called
+#define SPAWN_KEY_EVENT   7 // Reply formatted off the service thread (overlapped is a SpawnRequest)
+
+#define SPAWN_STREAM_STDOUT 1
+#define SPAWN_STREAM_STDERR 2
+
+// Most style runs sent in one "styled" frame
+#define SPAWN_MAX_RUNS 256
+
+// Longest wait for cancelled reads and writes to complete when the service stops
+#define SPAWN_STOP_TIMEOUT_MS 1000
+
+// Exit check interval of a script whose exit wait could not be registered
+#define SPAWN_EXIT_POLL_MS 250
+
+// One output pipe of a script with its outstanding read
+typedef struct
+{
+    OVERLAPPED overlapped;      // First, so a completion maps straight back to the stream
+    SpawnChild *child;
+    BYTE stream;                // SPAWN_STREAM_STDOUT or SPAWN_STREAM_STDERR
+    HANDLE pipe;                // Server end, NULL once closed
+    BOOL pending;               // TRUE while a read is outstanding
+    BOOL closed;                // TRUE once the script side closed
+    BOOL held;                  // Next read held back until the backlog has room (block policy)
+    DWORD sequence;             // Frames sent for the stream
+    LONGLONG readQpc;           // QPC of the last completed read
+    LONGLONG backlogQpc;        // QPC of the read the next frame's output arrived in
+    Coalescer coalescer;        // Collapses repeated lines before they are queued
+    FlowStream flow;            // Output waiting for the stream's budget
+    SgrParser sgr;              // Escape code state carried between chunks (native ANSI)
+    char buffer[SPAWN_READ_SIZE];
+} SpawnStream;
+
+struct SpawnChild
+{
+    DWORD id;                   // Chosen by Launcher.py
+    PROCESS_INFORMATION pi;
+    HANDLE stdinPipe;           // Server end of the script's stdin, NULL once closed
+    HANDLE exitWait;            // Registered wait that posts SPAWN_KEY_EXIT
+    BOOL exited;
+    SpawnStream output;
+    SpawnStream error;
+    SpawnService *service;
+};
+
+// An overlapped write to a script's stdin, freed when it completes
+typedef struct
+{
+    OVERLAPPED overlapped;
+    DWORD length;
+    char data[];
+} SpawnWrite;
+
+// A request copied from Launcher.py for the service thread
+typedef struct
+{
+    OVERLAPPED overlapped;      // Unused, lets the request travel as a completion packet
+    DWORD length;
+    char data[];
+} SpawnRequest;
+
+// Format a one-line event and send it to Launcher.py.
+static void sendSpawnEvent(SpawnService *service, const char *format, ...)
+{
+    char payload[128];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(payload, sizeof(payload), format, args);
+    va_end(args);
+
+    if (length > 0 && length < (int)sizeof(payload))
+        service->send(service->sendContext, payload, (DWORD)length);
+}
+
+// Format a one-line event and hand it to the service thread to send. Used by spawnChild, whose
+// pipe loop thread must not block on a send while Launcher.py is slow to read.
+static void postSpawnEvent(SpawnService *service, const char *format, ...)
+{
+    char payload[128];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(payload, sizeof(payload), format, args);
+    va_end(args);
+    if (length <= 0 || length >= (int)sizeof(payload))
+        return;
+
+    SpawnRequest *event = (SpawnRequest *)malloc(sizeof(SpawnRequest) + length);
+    if (!event)
+        return;
+    ZeroMemory(&event->overlapped, sizeof(event->overlapped));
+    event->length = (DWORD)length;
+    memcpy(event->data, payload, length);
+    if (!PostQueuedCompletionStatus(service->port, 0, SPAWN_KEY_EVENT, &event->overlapped))
+    {
+        printf("[WARNING] Spawn service could not queue '%s'. Error: %lu\n", payload, GetLastError());
+        free(event);
+    }
+}
+
+// Parse "<verb> <id>" at the start of a request. Returns a pointer past the header line.
+static const char *parseRequestHeader(const char *payload, DWORD length, char *verb, DWORD verbSize,
+                                      DWORD *id)
+{
+    const char *newline = (const char *)memchr(payload, '\n', length);
+    DWORD headerLength = newline ? (DWORD)(newline - payload) : length;
+    char header[64];
+
+    if (headerLength >= sizeof(header))
+        return NULL;
+    memcpy(header, payload, headerLength);
+    header[headerLength] = '\0';
+
+    char *space = strchr(header, ' ');
+    if (!space || (DWORD)(space - header) >= verbSize)
+        return NULL;
+    *space = '\0';
+    strcpy(verb, header);
+    *id = strtoul(space + 1, NULL, 10);
+    return newline ? newline + 1 : payload + length;
+}
+
+// Create one pipe of a script: the overlapped server end stays here, the client end (inheritable)
+// goes to the script. inbound is TRUE for stdout/stderr, FALSE for stdin.
+static BOOL createChildPipe(SpawnService *service, DWORD id, const char *kind, BOOL inbound,
+                            HANDLE *server, HANDLE *client)
+{
+    char pipeName[128];
+    snprintf(pipeName, sizeof(pipeName), "\\\\.\\pipe\\MSFSPyScriptManagerSpawn_%lu_%lu_%d_%s",
+             GetCurrentProcessId(), id, rand(), kind);
+
+    *server = CreateNamedPipe(pipeName, (inbound ? PIPE_ACCESS_INBOUND : PIPE_ACCESS_OUTBOUND) | FILE_FLAG_OVERLAPPED,
+                              PIPE_TYPE_BYTE | PIPE_WAIT, 1, service->pipeBufferSize,
+                              service->pipeBufferSize, 0, NULL);
+    if (*server == INVALID_HANDLE_VALUE)
+    {
+        *server = NULL;
+        return FALSE;
+    }
+
+    SECURITY_ATTRIBUTES sa = {sizeof(SECURITY_ATTRIBUTES), NULL, TRUE};
+    *client = CreateFile(pipeName, inbound ? GENERIC_WRITE : GENERIC_READ, 0, &sa, OPEN_EXISTING, 0, NULL);
+    if (*client == INVALID_HANDLE_VALUE)
+    {
+        *client = NULL;
+        return FALSE;
+    }
+
+    ULONG_PTR key = inbound ? SPAWN_KEY_READ : SPAWN_KEY_WRITE;
+    return CreateIoCompletionPort(*server, service->port, key, 0) != NULL;
+}
+
+static void closeChildHandles(SpawnChild *child)
+{
+    if (child->output.pipe)
+        CloseHandle(child->output.pipe);
+    if (child->error.pipe)
+        CloseHandle(child->error.pipe);
+    if (child->stdinPipe)
+        CloseHandle(child->stdinPipe);
+    if (child->pi.hProcess)
+        CloseHandle(child->pi.hProcess);
+    child->output.pipe = child->error.pipe = child->stdinPipe = child->pi.hProcess = NULL;
+}
+
+static void freeChild(SpawnChild *child)
+{
+    closeChildHandles(child);
+    closeFlowStream(&child->output.flow);
+    closeFlowStream(&child->error.flow);
+    free(child);
+}
+
+// Coalescer output: queue it for the stream's budget.
+static void queueStreamOutput(void *context, const char *data, DWORD length)
+{
+    SpawnStream *stream = (SpawnStream *)context;
+    flowStreamPut(&stream->flow, data, length);
+}
+
+// Thread pool callback of the registered exit wait: hand the exit to the service thread.
+static VOID CALLBACK childExited(PVOID parameter, BOOLEAN timedOut)
+{
+    SpawnChild *child = (SpawnChild *)parameter;
+    PostQueuedCompletionStatus(child->service->port, 0, SPAWN_KEY_EXIT, (LPOVERLAPPED)child);
+}
+
+// Convert length bytes of UTF-8 to a new wide string followed by terminators NULs. Returns
+// NULL if out of memory; invalid sequences become U+FFFD.
+static WCHAR *utf8ToWide(const char *text, DWORD length, DWORD terminators)
+{
+    int wideLength = length ? MultiByteToWideChar(CP_UTF8, 0, text, (int)length, NULL, 0) : 0;
+    WCHAR *wide = (WCHAR *)malloc((wideLength + terminators) * sizeof(WCHAR));
+    if (!wide)
+        return NULL;
+    if (wideLength)
+        MultiByteToWideChar(CP_UTF8, 0, text, (int)length, wide, wideLength);
+    for (DWORD i = 0; i < terminators; i++)
+        wide[wideLength + i] = L'\0';
+    return wide;
+}
+
+// Start a script for a spawn request. Runs on the calling (pipe loop) thread, which is where the
+// launcher creates every other process, so no other process can inherit the script's pipe ends.
+static void spawnChild(SpawnService *service, DWORD id, const char *body, DWORD length)
+{
+    const char *end = body + length;
+    const char *cwdEnd = (const char *)memchr(body, '\n', length);
+    const char *commandEnd = cwdEnd ? (const char *)memchr(cwdEnd + 1, '\n', end - cwdEnd - 1) : NULL;
+    if (!commandEnd)
+    {
+        postSpawnEvent(service, "failed %lu %lu", id, (DWORD)ERROR_INVALID_DATA);
+        return;
+    }
+
+    DWORD cwdLength = (DWORD)(cwdEnd - body);
+    DWORD commandLength = (DWORD)(commandEnd - cwdEnd - 1);
+    DWORD environmentLength = (DWORD)(end - commandEnd - 1);
+
+    // CreateProcessW wants writable, terminated wide copies; the environment ends with two NULs
+    WCHAR *cwd = utf8ToWide(body, cwdLength, 1);
+    WCHAR *commandLine = utf8ToWide(cwdEnd + 1, commandLength, 1);
+    WCHAR *environment = environmentLength ? utf8ToWide(commandEnd + 1, environmentLength, 2) : NULL;
+    SpawnChild *child = (SpawnChild *)calloc(1, sizeof(SpawnChild));
+    HANDLE outputClient = NULL, errorClient = NULL, inputClient = NULL;
+    DWORD error = 0;
+
+    if (!cwd || !commandLine || (environmentLength && !environment) || !child)
+    {
+        error = ERROR_NOT_ENOUGH_MEMORY;
+        goto done;
+    }
+    if (service->childCount >= SPAWN_MAX_CHILDREN)
+    {
+        error = ERROR_TOO_MANY_OPEN_FILES;
+        goto done;
+    }
+
+    child->id = id;
+    child->service = service;
+    child->output.child = child;
+    child->output.stream = SPAWN_STREAM_STDOUT;
+    child->error.child = child;
+    child->error.stream = SPAWN_STREAM_STDERR;
+    if (!initFlowStream(&child->output.flow, &service->flow) || !initFlowStream(&child->error.flow, &service->flow))
+    {
+        error = ERROR_NOT_ENOUGH_MEMORY;
+        goto done;
+    }
+    initCoalescer(&child->output.coalescer, service->coalesceWindowMs, queueStreamOutput, &child->output);
+    initCoalescer(&child->error.coalescer, service->coalesceWindowMs, queueStreamOutput, &child->error);
+    initSgrParser(&child->output.sgr);
+    initSgrParser(&child->error.sgr);
+
+    if (!createChildPipe(service, id, "out", TRUE, &child->output.pipe, &outputClient) ||
+        !createChildPipe(service, id, "err", TRUE, &child->error.pipe, &errorClient) ||
+        !createChildPipe(service, id, "in", FALSE, &child->stdinPipe, &inputClient))
+    {
+        error = GetLastError();
+        goto done;
+    }
+
+    STARTUPINFOW si = {sizeof(STARTUPINFOW)};
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = inputClient;
+    si.hStdOutput = outputClient;
+    si.hStdError = errorClient;
+
+    DWORD flags = CREATE_NO_WINDOW | CREATE_UNICODE_ENVIRONMENT;
+    BOOL started = service->job
+        ? createProcessInJobW(service->job, commandLine, flags, environment, cwd[0] ? cwd : NULL, &si, &child->pi)
+        : CreateProcessW(NULL, commandLine, NULL, NULL, TRUE, flags, environment, cwd[0] ? cwd : NULL, &si,
+                         &child->pi);
+    if (!started)
+    {
+        error = GetLastError();
+        goto done;
+    }
+    CloseHandle(child->pi.hThread);
+    child->pi.hThread = NULL;
+
+done:
+    // The script holds its own copies of the client ends
+    if (outputClient)
+        CloseHandle(outputClient);
+    if (errorClient)
+        CloseHandle(errorClient);
+    if (inputClient)
+        CloseHandle(inputClient);
+    free(cwd);
+    free(commandLine);
+    free(environment);
+
+    if (error)
+    {
+        printf("[WARNING] Spawn service could not start script %lu. Error: %lu\n", id, error);
+        postSpawnEvent(service, "failed %lu %lu", id, error);
+        if (child)
+            freeChild(child);
+        return;
+    }
+
+    InterlockedIncrement(&service->childCount);
+    postSpawnEvent(service, "started %lu %lu", id, child->pi.dwProcessId); // Queued ahead of its output
+    PostQueuedCompletionStatus(service->port, 0, SPAWN_KEY_ADD, (LPOVERLAPPED)child);
+}
+
+// Queue the next read on a stream. Called on the service thread only.
+static void beginStreamRead(SpawnStream *stream)
+{
+    SpawnService *service = stream->child->service;
+    if (stream->closed || stream->pending)
+        return;
+
+    ZeroMemory(&stream->overlapped, sizeof(stream->overlapped));
+    if (ReadFile(stream->pipe, stream->buffer, SPAWN_READ_SIZE, NULL, &stream->overlapped) ||
+        GetLastError() == ERROR_IO_PENDING)
+    {
+        // Completes through the port either way
+        stream->pending = TRUE;
+        service->pendingIo++;
+        return;
+    }
+    stream->closed = TRUE;
+}
+
+static int findChild(SpawnService *service, DWORD id)
+{
+    for (int i = 0; i < SPAWN_MAX_CHILDREN; i++)
+    {
+        if (service->children[i] && service->children[i]->id == id)
+            return i;
+    }
+    return -1;
+}
+
+// Report and free a child once it has exited and both of its output pipes and backlogs are
+// drained, so "exited" is always the last message for a script.
+static void finishChildIfDone(SpawnService *service, SpawnChild *child)
+{
+    if (!child->exited || !child->output.closed || !child->error.closed ||
+        child->output.pending || child->error.pending ||
+        !flowStreamIdle(&child->output.flow) || !flowStreamIdle(&child->error.flow))
+        return;
+
+    DWORD exitCode = 0;
+    GetExitCodeProcess(child->pi.hProcess, &exitCode);
+    sendSpawnEvent(service, "exited %lu %lu", child->id, exitCode);
+
+    if (child->exitWait)
+        UnregisterWaitEx(child->exitWait, INVALID_HANDLE_VALUE); // Its callback has already run
+    int index = findChild(service, child->id);
+    if (index >= 0 && service->children[index] == child)
+        service->children[index] = NULL;
+    freeChild(child);
+    InterlockedDecrement(&service->childCount);
+}
+
+// Send a chunk of output as plain text and style runs, in as many frames as it takes.
+static void sendStyledOutput(SpawnService *service, SpawnStream *stream, const char *data, DWORD length)
+{
+    char payload[64 + SPAWN_MAX_RUNS * SGR_RUN_SIZE + SPAWN_READ_SIZE];
+    char text[SPAWN_READ_SIZE];
+    SgrRun runs[SPAWN_MAX_RUNS];
+
+    while (length > 0)
+    {
+        DWORD textLength, runCount;
+        DWORD consumed = sgrParse(&stream->sgr, data, length, text, sizeof(text), &textLength, runs,
+                                  SPAWN_MAX_RUNS, &runCount);
+        data += consumed;
+        length -= consumed;
+        if (!textLength)
+        {
+            if (!consumed)
+                break;
+            continue; // Only escape codes so far
+        }
+
+        int headerLength = snprintf(payload, 64, "styled %lu %u %lu %lu %lld\n", stream->child->id, stream->stream,
+                                    runCount, ++stream->sequence, stream->backlogQpc);
+        sgrWriteRuns(runs, runCount, (BYTE *)payload + headerLength);
+        DWORD runBytes = runCount * SGR_RUN_SIZE;
+        memcpy(payload + headerLength + runBytes, text, textLength);
+        service->send(service->sendContext, payload, headerLength + runBytes + textLength);
+    }
+}
+
+// Forward as much of a stream's backlog to Launcher.py as its budget allows.
+static void relayStream(SpawnService *service, SpawnStream *stream)
+{
+    char text[SPAWN_READ_SIZE];
+    char payload[64 + SPAWN_READ_SIZE];
+
+    for (;;)
+    {
+        DWORD length = flowStreamTake(&stream->flow, text, sizeof(text));
+        if (!length)
+            break;
+        if (service->nativeAnsi)
+        {
+            sendStyledOutput(service, stream, text, length);
+        }
+        else
+        {
+            int headerLength = snprintf(payload, 64, "out %lu %u %lu %lld\n", stream->child->id, stream->stream,
+                                        ++stream->sequence, stream->backlogQpc);
+            memcpy(payload + headerLength, text, length);
+            service->send(service->sendContext, payload, headerLength + length);
+        }
+
+        // Output held back by the budget is stamped with the newest read, which
+        // under-reports its wait rather than letting the stamp age without bound
+        stream->backlogQpc = stream->readQpc;
+    }
+}
+
+// Queue the next read of a stream unless the block policy holds it until the backlog drains.
+static void continueStream(SpawnStream *stream)
+{
+    stream->held = !flowStreamCanRead(&stream->flow, SPAWN_READ_SIZE);
+    if (!stream->held)
+        beginStreamRead(stream);
+}
+
+// Relay the backlogs the budgets allow now, release held reads and poll the exit of scripts
+// without an exit wait. Called on every pass of the service thread; returns how long it may
+// sleep before the next budget refill or exit check is due.
+static DWORD relayBacklogs(SpawnService *service)
+{
+    DWORD timeout = INFINITE;
+
+    for (int i = 0; i < SPAWN_MAX_CHILDREN; i++)
+    {
+        SpawnChild *child = service->children[i];
+        if (!child)
+            continue;
+
+        if (!child->exitWait && !child->exited)
+        {
+            if (WaitForSingleObject(child->pi.hProcess, 0) == WAIT_OBJECT_0)
+                child->exited = TRUE;
+            else if (SPAWN_EXIT_POLL_MS < timeout)
+                timeout = SPAWN_EXIT_POLL_MS;
+        }
+
+        SpawnStream *streams[] = {&child->output, &child->error};
+        for (int j = 0; j < 2; j++)
+        {
+            SpawnStream *stream = streams[j];
+            if (stream->closed)
+                coalescerFlush(&stream->coalescer);
+            else
+                coalescerFlushIfDue(&stream->coalescer);
+            relayStream(service, stream);
+            if (stream->held && !stream->closed)
+                continueStream(stream);
+
+            DWORD delay = flowStreamDelayMs(&stream->flow);
+            DWORD summaryDelay = coalescerTimeout(&stream->coalescer);
+            if (delay < timeout)
+                timeout = delay;
+            if (summaryDelay < timeout)
+                timeout = summaryDelay;
+        }
+        finishChildIfDone(service, child); // May free the child
+    }
+    return timeout;
+}
+
+// Forward a completed read to Launcher.py and queue the next one.
+static void completeStreamRead(SpawnService *service, SpawnStream *stream, BOOL succeeded, DWORD bytesRead)
+{
+    stream->pending = FALSE;
+    service->pendingIo--;
+
+    if (!succeeded)
+    {
+        // ERROR_BROKEN_PIPE: the script and everything holding its stdout have gone
+        stream->closed = TRUE;
+        coalescerFlush(&stream->coalescer);
+        relayStream(service, stream);
+        finishChildIfDone(service, stream->child);
+        return;
+    }
+
+    if (bytesRead > 0)
+    {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        stream->readQpc = now.QuadPart;
+        if (flowStreamIdle(&stream->flow))
+            stream->backlogQpc = now.QuadPart;
+
+        if (service->coalesceWindowMs)
+            coalescerFeed(&stream->coalescer, stream->buffer, bytesRead);
+        else
+            flowStreamPut(&stream->flow, stream->buffer, bytesRead);
+        relayStream(service, stream);
+    }
+
+    continueStream(stream);
+    if (stream->closed)
+        finishChildIfDone(service, stream->child);
+}
+
+// Handle an input or close request on the service thread.
+static void handleRequest(SpawnService *service, SpawnRequest *request)
+{
+    char verb[16];
+    DWORD id;
+    const char *body = parseRequestHeader(request->data, request->length, verb, sizeof(verb), &id);
+    int index = body ? findChild(service, id) : -1;
+    SpawnChild *child = index >= 0 ? service->children[index] : NULL;
+
+    if (!child)
+        return; // Already gone, nothing to deliver
+
+    if (strcmp(verb, "kill") == 0)
+    {
+        // Its exit then arrives like any other
+        if (!child->exited)
+            TerminateProcess(child->pi.hProcess, 1);
+    }
+    else if (!child->stdinPipe)
+    {
+        return; // Stdin already closed
+    }
+    else if (strcmp(verb, "input") == 0)
+    {
+        DWORD length = (DWORD)(request->data + request->length - body);
+        SpawnWrite *write = (SpawnWrite *)malloc(sizeof(SpawnWrite) + length);
+        if (!length || !write)
+        {
+            free(write);
+            return;
+        }
+        ZeroMemory(&write->overlapped, sizeof(write->overlapped));
+        write->length = length;
+        memcpy(write->data, body, length);
+        if (WriteFile(child->stdinPipe, write->data, length, NULL, &write->overlapped) ||
+            GetLastError() == ERROR_IO_PENDING)
+            service->pendingIo++;
+        else
+            free(write);
+    }
+    else if (strcmp(verb, "close") == 0)
+    {
+        CloseHandle(child->stdinPipe);
+        child->stdinPipe = NULL;
+    }
+}
+
+// Close every child's pipes and wait for the cancelled I/O, so no OVERLAPPED is freed while
+// the system may still write to it.
+static void stopChildren(SpawnService *service)
+{
+    for (int i = 0; i < SPAWN_MAX_CHILDREN; i++)
+    {
+        SpawnChild *child = service->children[i];
+        if (child && child->exitWait)
+        {
+            UnregisterWaitEx(child->exitWait, INVALID_HANDLE_VALUE);
+            child->exitWait = NULL;
+        }
+        if (child)
+            closeChildHandles(child); // Closing a handle cancels its outstanding I/O
+    }
+
+    // Wait for the cancelled I/O, then take whatever else is still queued without waiting
+    DWORD startTick = GetTickCount();
+    for (;;)
+    {
+        DWORD elapsed = GetTickCount() - startTick;
+        if (service->pendingIo > 0 && elapsed >= SPAWN_STOP_TIMEOUT_MS)
+            break;
+
+        DWORD bytes;
+        ULONG_PTR key;
+        LPOVERLAPPED overlapped = NULL;
+        DWORD timeout = service->pendingIo > 0 ? SPAWN_STOP_TIMEOUT_MS - elapsed : 0;
+        GetQueuedCompletionStatus(service->port, &bytes, &key, &overlapped, timeout);
+        if (!overlapped)
+            break;
+        if (key == SPAWN_KEY_READ || key == SPAWN_KEY_WRITE)
+            service->pendingIo--;
+        if (key == SPAWN_KEY_WRITE || key == SPAWN_KEY_REQUEST || key == SPAWN_KEY_EVENT)
+            free(overlapped);
+        if (key == SPAWN_KEY_ADD)
+        {
+            // Started but never taken into the table, so nothing else refers to it
+            freeChild((SpawnChild *)overlapped);
+            InterlockedDecrement(&service->childCount);
+        }
+    }
+
+    // Leaking beats freeing an OVERLAPPED the system might still complete into
+    if (service->pendingIo > 0)
+        printf("[WARNING] Spawn service stopped with %ld operations outstanding.\n", service->pendingIo);
+    else
+    {
+        for (int i = 0; i < SPAWN_MAX_CHILDREN; i++)
+        {
+            if (service->children[i])
+                freeChild(service->children[i]);
+        }
+    }
+    ZeroMemory(service->children, sizeof(service->children));
+}
+
+// Service thread: every read, write, request and exit of every script completes here.
+static DWORD WINAPI spawnServiceThread(LPVOID parameter)
+{
+    SpawnService *service = (SpawnService *)parameter;
+
+    for (;;)
+    {
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        LPOVERLAPPED overlapped = NULL;
+        DWORD timeout = relayBacklogs(service);
+        BOOL succeeded = GetQueuedCompletionStatus(service->port, &bytes, &key, &overlapped, timeout);
+
+        if (!overlapped && !succeeded && GetLastError() == WAIT_TIMEOUT)
+            continue; // A budget refilled
+        if (!overlapped && !succeeded)
+        {
+            printf("[ERROR] Spawn service port failed. Error: %lu\n", GetLastError());
+            break;
+        }
+
+        if (key == SPAWN_KEY_STOP)
+            break;
+
+        switch (key)
+        {
+        case SPAWN_KEY_READ:
+            completeStreamRead(service, (SpawnStream *)overlapped, succeeded, bytes);
+            break;
+
+        case SPAWN_KEY_WRITE:
+            service->pendingIo--;
+            free(overlapped);
+            break;
+
+        case SPAWN_KEY_REQUEST:
+            handleRequest(service, (SpawnRequest *)overlapped);
+            free(overlapped);
+            break;
+
+        case SPAWN_KEY_EVENT:
+        {
+            SpawnRequest *event = (SpawnRequest *)overlapped;
+            service->send(service->sendContext, event->data, event->length);
+            free(event);
+            break;
+        }
+
+        case SPAWN_KEY_ADD:
+        {
+            // spawnChild keeps the count below the limit, so a free slot always exists
+            SpawnChild *child = (SpawnChild *)overlapped;
+            int index = 0;
+            while (service->children[index])
+                index++;
+            service->children[index] = child;
+
+            // Registered here so the exit packet can only be handled after this one
+            if (!RegisterWaitForSingleObject(&child->exitWait, child->pi.hProcess, childExited, child,
+                                             INFINITE, WT_EXECUTEONLYONCE))
+            {
+                // relayBacklogs polls the exit instead
+                child->exitWait = NULL;
+                printf("[WARNING] Failed to watch script %lu for exit, polling it. Error: %lu\n", child->id,
+                       GetLastError());
+            }
+            beginStreamRead(&child->output);
+            beginStreamRead(&child->error);
+            break;
+        }
+
+        case SPAWN_KEY_EXIT:
+            ((SpawnChild *)overlapped)->exited = TRUE;
+            finishChildIfDone(service, (SpawnChild *)overlapped);
+            break;
+        }
+    }
+
+    stopChildren(service);
+    return 0;
+}
+
+// Create the completion port and start the service thread.
+BOOL initSpawnService(SpawnService *service, HANDLE job, DWORD pipeBufferSize, const FlowSettings *flow,
+                      DWORD coalesceWindowMs, BOOL nativeAnsi, SpawnSendFn send, void *sendContext)
+{
+    ZeroMemory(service, sizeof(*service));
+    service->job = job;
+    service->pipeBufferSize = pipeBufferSize;
+    service->flow = *flow;
+    service->coalesceWindowMs = coalesceWindowMs;
+    service->nativeAnsi = nativeAnsi;
+    service->send = send;
+    service->sendContext = sendContext;
+
+    service->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (!service->port)
+        return FALSE;
+
+    service->thread = CreateThread(NULL, 0, spawnServiceThread, service, 0, NULL);
+    if (!service->thread)
+    {
+        CloseHandle(service->port);
+        service->port = NULL;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Queue a request received from Launcher.py.
+void spawnServiceRequest(SpawnService *service, const char *payload, DWORD length)
+{
+    char verb[16];
+    DWORD id;
+    const char *body = parseRequestHeader(payload, length, verb, sizeof(verb), &id);
+
+    if (!body)
+    {
+        printf("[WARNING] Ignoring malformed spawn service request.\n");
+        return;
+    }
+
+    if (strcmp(verb, "spawn") == 0)
+    {
+        spawnChild(service, id, body, (DWORD)(payload + length - body));
+        return;
+    }
+
+    SpawnRequest *request = (SpawnRequest *)malloc(sizeof(SpawnRequest) + length);
+    if (!request)
+        return;
+    request->length = length;
+    memcpy(request->data, payload, length);
+    if (!PostQueuedCompletionStatus(service->port, 0, SPAWN_KEY_REQUEST, &request->overlapped))
+        free(request);
+}
+
+// Stop the service thread and release every child's pipes.
+void closeSpawnService(SpawnService *service)
+{
+    if (service->thread)
+    {
+        PostQueuedCompletionStatus(service->port, 0, SPAWN_KEY_STOP, NULL);
+        WaitForSingleObject(service->thread, INFINITE);
+        CloseHandle(service->thread);
+        service->thread = NULL;
+    }
+    if (service->port)
+    {
+        CloseHandle(service->port);
+        service->port = NULL;
+    }
+}
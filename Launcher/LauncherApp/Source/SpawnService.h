@@ -0,0 +1,80 @@
+#ifndef SPAWN_SERVICE_H
+#define SPAWN_SERVICE_H
+
+#include <windows.h>
+
+#include "Coalescer.h"
+#include "FlowControl.h"
+#include "SgrParser.h"
+
+// Starts scripts for Launcher.py and relays their output, so Launcher.py needs one reader
+// thread for every script instead of five threads per script. One thread serves all children
+// through an I/O completion port (pipe reads, stdin writes, requests and process exits).
+//
+// Requests arrive as IPC_CHANNEL_SPAWN frames on Launcher.py's stdout; replies go back as
+// IPC_CHANNEL_SPAWN frames on the command pipe. Each payload starts with a text line
+// (spawn_service.py mirrors this):
+//
+//   Launcher.py -> launcher
+//     spawn <id>\n<working directory or empty>\n<command line>\n<environment block>
+//         All UTF-8, started with CreateProcessW. The environment block is NAME=VALUE\0...\0;
+//         empty inherits the launcher's
+//     input <id>\n<bytes for stdin>
+//     close <id>                   Close the script's stdin
+//     kill <id>                    Terminate a script Launcher.py gave up on
+//
+//   launcher -> Launcher.py
+//     started <id> <pid>
+//     failed <id> <error code>
+//     out <id> <1 stdout | 2 stderr> <sequence> <qpc>\n<bytes>
+//     styled <id> <1 | 2> <run count> <sequence> <qpc>\n<runs><text>
+//         Sent instead of "out" with native ANSI parsing (see SgrParser.h): the text has its
+//         escape codes removed and each run is SGR_RUN_SIZE bytes (offset, length, style ID)
+//         Both carry the stream's frame sequence number (from 1, a gap means a lost frame) and
+//         the QueryPerformanceCounter value of the pipe read the output arrived in, so
+//         Launcher.py can measure pipe-to-screen latency
+//     exited <id> <exit code>      Sent after the last output of the script
+//
+// Each stdout and stderr stream first collapses repeated lines (see Coalescer.h) and then has
+// its own flow control budget (see FlowControl.h), so a script flooding its output is
+// throttled, coalesced or trimmed before it reaches the UI.
+
+// Most scripts running through the service at once
+#define SPAWN_MAX_CHILDREN 64
+
+// Bytes requested per read from a script's stdout or stderr
+#define SPAWN_READ_SIZE 4096
+
+// Sends one frame payload to Launcher.py on IPC_CHANNEL_SPAWN. Called from the service thread.
+typedef BOOL (*SpawnSendFn)(void *context, const char *payload, DWORD length);
+
+typedef struct SpawnChild SpawnChild;
+
+typedef struct
+{
+    HANDLE port;                // I/O completion port serving every child
+    HANDLE thread;              // Service thread
+    HANDLE job;                 // Job the scripts are created in
+    DWORD pipeBufferSize;       // Kernel buffer size of each script pipe
+    FlowSettings flow;          // Budget and policy of every script stream
+    DWORD coalesceWindowMs;     // Summary interval of repeated lines, 0 passes every copy on
+    BOOL nativeAnsi;            // Send output as "styled" text and runs instead of raw "out"
+    SpawnSendFn send;
+    void *sendContext;
+    SpawnChild *children[SPAWN_MAX_CHILDREN]; // Owned by the service thread
+    volatile LONG childCount;   // Scripts started and not finished yet
+    LONG pendingIo;             // Reads and writes not completed yet (service thread only)
+} SpawnService;
+
+// Create the completion port and start the service thread. Returns FALSE on failure.
+BOOL initSpawnService(SpawnService *service, HANDLE job, DWORD pipeBufferSize, const FlowSettings *flow,
+                      DWORD coalesceWindowMs, BOOL nativeAnsi, SpawnSendFn send, void *sendContext);
+
+// Queue a request received from Launcher.py. The payload is copied.
+void spawnServiceRequest(SpawnService *service, const char *payload, DWORD length);
+
+// Stop the service thread, cancel outstanding I/O and close every child's pipes. The scripts
+// themselves are left to the job.
+void closeSpawnService(SpawnService *service);
+
+#endif // SPAWN_SERVICE_H
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include "StartupProfile.h"
+
+// Reset the profile and record the time origin.
+void initStartupProfile(StartupProfile *profile, BOOL enabled, LONGLONG mainQpc)
+{
+    ZeroMemory(profile, sizeof(*profile));
+    profile->enabled = enabled && QueryPerformanceFrequency(&profile->frequency);
+    markStartupPhaseAt(profile, "launcher_main", mainQpc);
+}
+
+// Record a phase at the current time.
+void markStartupPhase(StartupProfile *profile, const char *name)
+{
+    if (!profile->enabled)
+        return;
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    markStartupPhaseAt(profile, name, now.QuadPart);
+}
+
+// Record a phase using a QPC value taken elsewhere.
+void markStartupPhaseAt(StartupProfile *profile, const char *name, LONGLONG qpc)
+{
+    if (!profile->enabled || qpc == 0 || profile->markCount >= STARTUP_PROFILE_MAX_MARKS)
+        return;
+
+    profile->marks[profile->markCount].name = name;
+    profile->marks[profile->markCount].qpc = qpc;
+    profile->markCount++;
+}
+
+// Convert a QPC tick delta to milliseconds.
+static double ticksToMs(const StartupProfile *profile, LONGLONG ticks)
+{
+    return (double)ticks * 1000.0 / (double)profile->frequency.QuadPart;
+}
+
+// Write the recorded phases to path as CSV.
+BOOL writeStartupProfile(StartupProfile *profile, const char *path)
+{
+    if (!profile->enabled || profile->markCount == 0)
+        return FALSE;
+
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        printf("[WARNING] Failed to write startup profile: %s\n", path);
+        return FALSE;
+    }
+
+    // Marks from Launcher.py arrive late, so order everything by time before writing
+    for (DWORD i = 1; i < profile->markCount; i++)
+    {
+        StartupMark mark = profile->marks[i];
+        DWORD j = i;
+        while (j > 0 && profile->marks[j - 1].qpc > mark.qpc)
+        {
+            profile->marks[j] = profile->marks[j - 1];
+            j--;
+        }
+        profile->marks[j] = mark;
+    }
+
+    LONGLONG origin = profile->marks[0].qpc;
+    fprintf(file, "# MSFS-PyScriptManager startup profile, launcher built %s %s\n", __DATE__, __TIME__);
+    fprintf(file, "# QPC frequency %lld Hz\n", profile->frequency.QuadPart);
+    fprintf(file, "phase,qpc,ms_since_start,ms_since_previous\n");
+    for (DWORD i = 0; i < profile->markCount; i++)
+    {
+        const StartupMark *mark = &profile->marks[i];
+        LONGLONG previous = i > 0 ? profile->marks[i - 1].qpc : origin;
+        fprintf(file, "%s,%lld,%.3f,%.3f\n", mark->name, mark->qpc,
+                ticksToMs(profile, mark->qpc - origin), ticksToMs(profile, mark->qpc - previous));
+    }
+    fclose(file);
+
+    profile->written = TRUE;
+    printf("[INFO] Startup profile written to %s\n", path);
+    return TRUE;
+}
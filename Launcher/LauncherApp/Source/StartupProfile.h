@@ -0,0 +1,40 @@
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+#include <windows.h>
+
+// Most phases recorded in one trace
+#define STARTUP_PROFILE_MAX_MARKS 32
+
+// One named point in start-up, as a raw QueryPerformanceCounter value
+typedef struct
+{
+    const char *name;
+    LONGLONG qpc;
+} StartupMark;
+
+// QPC timestamps for each start-up phase, written to a trace file for comparing builds.
+// Marking is a no-op while the profile is disabled.
+typedef struct
+{
+    BOOL enabled;
+    BOOL written;             // Trace file already produced
+    LARGE_INTEGER frequency;  // QPC ticks per second
+    DWORD markCount;
+    StartupMark marks[STARTUP_PROFILE_MAX_MARKS];
+} StartupProfile;
+
+// Reset the profile and, when enabled, record mainQpc (taken on entry to main) as the
+// "launcher_main" mark, the time origin of the trace.
+void initStartupProfile(StartupProfile *profile, BOOL enabled, LONGLONG mainQpc);
+
+// Record a phase at the current time. name must stay valid (use string literals).
+void markStartupPhase(StartupProfile *profile, const char *name);
+
+// Record a phase using a QPC value taken elsewhere (e.g. by Launcher.py). Zero values are ignored.
+void markStartupPhaseAt(StartupProfile *profile, const char *name, LONGLONG qpc);
+
+// Write the recorded phases to path as CSV. Returns FALSE if the file could not be written.
+BOOL writeStartupProfile(StartupProfile *profile, const char *path);
+
+#endif // STARTUP_PROFILE_H
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include "Telemetry.h"
+
+// Layout of PROCESS_MEMORY_COUNTERS_EX, declared here so psapi.h is not required
+typedef struct
+{
+    DWORD cb;
+    DWORD PageFaultCount;
+    SIZE_T PeakWorkingSetSize;
+    SIZE_T WorkingSetSize;
+    SIZE_T QuotaPeakPagedPoolUsage;
+    SIZE_T QuotaPagedPoolUsage;
+    SIZE_T QuotaPeakNonPagedPoolUsage;
+    SIZE_T QuotaNonPagedPoolUsage;
+    SIZE_T PagefileUsage;
+    SIZE_T PeakPagefileUsage;
+    SIZE_T PrivateUsage;
+} ProcessMemoryCounters;
+
+// Leading fields of PROCESS_BASIC_INFORMATION (ntdll), enough to read the parent PID
+typedef struct
+{
+    LONG_PTR ExitStatus;
+    PVOID PebBaseAddress;
+    ULONG_PTR AffinityMask;
+    LONG_PTR BasePriority;
+    ULONG_PTR UniqueProcessId;
+    ULONG_PTR InheritedFromUniqueProcessId;
+} ProcessBasicInformation;
+
+// Define types for function pointers to dynamically load the query functions.
+typedef BOOL (WINAPI *GetProcessMemoryInfo_t)(HANDLE, ProcessMemoryCounters *, DWORD);
+typedef LONG (WINAPI *NtQueryInformationProcess_t)(HANDLE, int, PVOID, ULONG, ULONG *);
+
+static GetProcessMemoryInfo_t g_getProcessMemoryInfo = NULL;
+static NtQueryInformationProcess_t g_ntQueryInformationProcess = NULL;
+
+// Load the memory and parent-process query functions. kernel32 exports K32GetProcessMemoryInfo
+// on Windows 7 and later, psapi.dll is the fallback.
+static void loadTelemetryFunctions(void)
+{
+    HMODULE kernel32 = GetModuleHandle("kernel32.dll");
+    HMODULE ntdll = GetModuleHandle("ntdll.dll");
+
+    if (kernel32)
+        g_getProcessMemoryInfo = (GetProcessMemoryInfo_t)GetProcAddress(kernel32, "K32GetProcessMemoryInfo");
+    if (!g_getProcessMemoryInfo)
+    {
+        HMODULE psapi = LoadLibrary("psapi.dll");
+        if (psapi)
+            g_getProcessMemoryInfo = (GetProcessMemoryInfo_t)GetProcAddress(psapi, "GetProcessMemoryInfo");
+    }
+    if (ntdll)
+        g_ntQueryInformationProcess = (NtQueryInformationProcess_t)GetProcAddress(ntdll, "NtQueryInformationProcess");
+}
+
+// Prepare a sampler for the processes in the given job.
+void initTelemetrySampler(TelemetrySampler *sampler, HANDLE job, DWORD intervalMs)
+{
+    ZeroMemory(sampler, sizeof(*sampler));
+    sampler->job = job;
+    sampler->intervalMs = intervalMs;
+    QueryPerformanceFrequency(&sampler->frequency);
+    QueryPerformanceCounter(&sampler->lastSample);
+    loadTelemetryFunctions();
+}
+
+// Look up the previous sample of a process, or NULL if it is new.
+static const TelemetryHistory *findHistory(const TelemetrySampler *sampler, DWORD pid)
+{
+    for (DWORD i = 0; i < sampler->historyCount; i++)
+    {
+        if (sampler->history[i].pid == pid)
+            return &sampler->history[i];
+    }
+    return NULL;
+}
+
+// Read the parent PID of a process, 0 if it cannot be determined.
+static DWORD queryParentPid(HANDLE process)
+{
+    ProcessBasicInformation info;
+    if (!g_ntQueryInformationProcess ||
+        g_ntQueryInformationProcess(process, 0 /* ProcessBasicInformation */, &info, sizeof(info), NULL) != 0)
+        return 0;
+    return (DWORD)info.InheritedFromUniqueProcessId;
+}
+
+// Fill one record for a process. Returns FALSE if the process could not be queried.
+static BOOL sampleProcess(const TelemetrySampler *sampler, DWORD pid, double elapsed100ns,
+                          TelemetryRecord *record)
+{
+    HANDLE process = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
+    if (!process)
+        return FALSE;
+
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(process, &created, &exited, &kernel, &user))
+    {
+        CloseHandle(process);
+        return FALSE;
+    }
+
+    ZeroMemory(record, sizeof(*record));
+    record->pid = pid;
+    record->cpuTime = (((ULONGLONG)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime) +
+                      (((ULONGLONG)user.dwHighDateTime << 32) | user.dwLowDateTime);
+
+    // Parent PIDs never change, only query them for processes not seen before
+    const TelemetryHistory *previous = findHistory(sampler, pid);
+    record->parentPid = previous ? previous->parentPid : queryParentPid(process);
+    if (previous && elapsed100ns > 0 && record->cpuTime >= previous->cpuTime)
+        record->cpuPercentX100 = (DWORD)((record->cpuTime - previous->cpuTime) * 10000.0 / elapsed100ns);
+
+    ProcessMemoryCounters memory;
+    ZeroMemory(&memory, sizeof(memory));
+    memory.cb = sizeof(memory);
+    if (g_getProcessMemoryInfo && g_getProcessMemoryInfo(process, &memory, sizeof(memory)))
+    {
+        record->workingSet = memory.WorkingSetSize;
+        record->privateBytes = memory.PrivateUsage;
+    }
+
+    CloseHandle(process);
+    return TRUE;
+}
+
+// Take a sample of every process in the job and publish it to the table.
+void sampleTelemetry(TelemetrySampler *sampler, TelemetryTable *table)
+{
+    // Process ID list header followed by room for every process we track
+    struct
+    {
+        JOBOBJECT_BASIC_PROCESS_ID_LIST list;
+        ULONG_PTR more[TELEMETRY_MAX_PROCESSES];
+    } pids;
+    TelemetryRecord records[TELEMETRY_MAX_PROCESSES];
+    DWORD recordCount = 0;
+
+    ZeroMemory(&pids, sizeof(pids));
+    if (!QueryInformationJobObject(sampler->job, JobObjectBasicProcessIdList, &pids, sizeof(pids), NULL) &&
+        GetLastError() != ERROR_MORE_DATA)
+        return;
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    double elapsed100ns = (double)(now.QuadPart - sampler->lastSample.QuadPart) * 1e7 / sampler->frequency.QuadPart;
+    sampler->lastSample = now;
+
+    DWORD pidCount = pids.list.NumberOfProcessIdsInList;
+    if (pidCount > TELEMETRY_MAX_PROCESSES)
+        pidCount = TELEMETRY_MAX_PROCESSES;
+
+    for (DWORD i = 0; i < pidCount; i++)
+    {
+        if (sampleProcess(sampler, (DWORD)pids.list.ProcessIdList[i], elapsed100ns, &records[recordCount]))
+            recordCount++;
+    }
+
+    // Remember this sample for the next interval
+    sampler->historyCount = recordCount;
+    for (DWORD i = 0; i < recordCount; i++)
+    {
+        sampler->history[i].pid = records[i].pid;
+        sampler->history[i].parentPid = records[i].parentPid;
+        sampler->history[i].cpuTime = records[i].cpuTime;
+    }
+
+    // Publish under the sequence lock
+    InterlockedIncrement(&table->sequence);
+    MemoryBarrier();
+    CopyMemory(table->records, records, recordCount * sizeof(TelemetryRecord));
+    table->recordCount = recordCount;
+    table->intervalMs = sampler->intervalMs;
+    table->sampleCount++;
+    MemoryBarrier();
+    InterlockedIncrement(&table->sequence);
+}
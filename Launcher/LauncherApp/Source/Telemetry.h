@@ -0,0 +1,57 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <windows.h>
+
+// Most processes tracked per sample (the Python UI, its scripts and their children)
+#define TELEMETRY_MAX_PROCESSES 64
+
+// One sampled process. Mirrored in launcher_state.py.
+typedef struct
+{
+    DWORD pid;                 // Process ID
+    DWORD parentPid;           // Parent process ID (lets the UI sum a script's whole tree)
+    DWORD cpuPercentX100;      // CPU use over the last interval, percent of one core * 100
+    DWORD reserved;
+    ULONGLONG cpuTime;         // Total user + kernel CPU time (100 ns units)
+    ULONGLONG workingSet;      // Working set (bytes)
+    ULONGLONG privateBytes;    // Private committed memory (bytes)
+} TelemetryRecord;
+
+// Snapshot of every process in the job, published in the shared state block.
+// sequence is odd while the launcher is writing (same scheme as the job accounting).
+typedef struct
+{
+    volatile LONG sequence;
+    DWORD sampleCount;         // Increments once per completed sample
+    DWORD recordCount;         // Valid entries in records
+    DWORD intervalMs;          // Sampling interval (0 when telemetry is disabled)
+    TelemetryRecord records[TELEMETRY_MAX_PROCESSES];
+} TelemetryTable;
+
+// CPU time remembered between samples to compute per-interval usage
+typedef struct
+{
+    DWORD pid;
+    DWORD parentPid;
+    ULONGLONG cpuTime;
+} TelemetryHistory;
+
+// Samples GetProcessTimes / GetProcessMemoryInfo for every process in a job
+typedef struct
+{
+    HANDLE job;
+    DWORD intervalMs;
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER lastSample;
+    DWORD historyCount;
+    TelemetryHistory history[TELEMETRY_MAX_PROCESSES];
+} TelemetrySampler;
+
+// Prepare a sampler for the processes in the given job.
+void initTelemetrySampler(TelemetrySampler *sampler, HANDLE job, DWORD intervalMs);
+
+// Take a sample of every process in the job and publish it to the table.
+void sampleTelemetry(TelemetrySampler *sampler, TelemetryTable *table);
+
+#endif // TELEMETRY_H
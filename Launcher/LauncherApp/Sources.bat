@@ -0,0 +1,3 @@
+@echo off
+REM Source files that make up the launcher, shared by Build.bat and Build_msvc.bat
+set "sources=launcher.c Config.c ConsoleWriter.c SharedState.c JobObject.c Telemetry.c InterpreterPool.c StartupProfile.c Ipc.c RingLog.c PostMortem.c ProcessPolicy.c PipeReader.c Headless.c SpawnService.c FlowControl.c Coalescer.c SgrParser.c ShmRing.c Metrics.c CommandLine.c Preflight.c SingleInstance.c"
@@ -10,7 +10,6 @@ import subprocess
 import sys
 import threading
 import time
-from multiprocessing import Process, Event
 from pathlib import Path
 from tkinter import messagebox
 from typing import Dict
@@ -21,7 +20,7 @@ from threading import Lock
 import pstats
 
 import numpy as np
-from parse_ansi import AnsiParser
+from parse_ansi import AnsiParser, style_from_id
 
 import tkinter as tk
 from tkinter import filedialog, scrolledtext, TclError
@@ -32,6 +31,14 @@ import re
 from ttkthemes import ThemedTk
 
 from ordered_logger import OrderedLogger
+from launcher_state import SharedLauncherState
+from job_object import JobObject
+from interpreter_pool import InterpreterPool
+from launcher_ipc import CHANNEL_CONTROL, CHANNEL_SPAWN, FrameDecoder, install_framed_stdio
+from spawn_service import CallbackQueue, SpawnService, STREAM_STDERR, STREAM_STDOUT
+from shm_ring import ShmRingReader
+from latency_trace import LatencyTracker
+from launcher_metrics import LauncherMetrics
 
 import faulthandler
 import traceback
@@ -67,6 +74,15 @@ FRAME_BG_COLOR = "#2E2E2E"
 # Delay load between scripts
 SCRIPT_LOAD_DELAY_MS = 20
 
+# Command prefix of requests a second start of the launcher exe forwards (see SingleInstance.h)
+ATTACH_COMMAND_PREFIX = "attach "
+
+# Seconds without a launcher heartbeat before the UI shuts itself down
+HEARTBEAT_TIMEOUT = 5
+
+# Seconds the spawn ring reader sleeps before re-checking for records it was not woken for
+SPAWN_RING_WAIT = 0.05
+
 # Configure logging globally
 logger = OrderedLogger(
     filename="shutdown_log.txt",  # Specify the log file
@@ -387,11 +403,16 @@ class ScriptTab(Tab):
         self.font_bold = ("Consolas", 12, "bold")
 
         self._ansi_parser = AnsiParser()
+        self._tags = {}  # (color, bold) -> tag name
+        self._style_tags = {}  # Launcher style ID -> tag name
 
-        # Text buffer
+        # Text buffer of (text, tag) segments, "" for untagged text
         self.text_buffer = []
         self.is_flushing = False
 
+        # Launcher stamps of the buffered output while latency tracing is on
+        self.trace_stamps = []
+
     def build_content(self):
         """Build the content of the ScriptTab."""
 
@@ -536,8 +557,11 @@ class ScriptTab(Tab):
             command=command,
             stdout_callback=self._insert_stdout,
             stderr_callback=self._insert_stderr,
+            styled_callback=self._insert_styled,
+            trace_callback=self._note_trace_stamp,
             script_tab=self,
             script_name=self.script_path.name,
+            script_path=self.script_path.resolve(),
         )
 
     # TODO may not be best place for these
@@ -547,16 +571,38 @@ class ScriptTab(Tab):
     def _insert_stderr(self, text):
         self._insert_text(text)
 
+    def _note_trace_stamp(self, stream_name, sequence, qpc):
+        """Hold the launcher's stamp of the output buffered next until it is inserted."""
+        self.trace_stamps.append((stream_name, sequence, qpc))
+
     def _insert_text(self, text):
         """Buffer text for periodic insertion with ANSI color handling."""
         if not (self.text_widget and self.text_widget.winfo_exists()):
             return
 
         # Parse the ANSI colors and buffer the parsed segments
-        parsed_segments = self._ansi_parser.parse_ansi_colors(text)
-        self.text_buffer.extend(parsed_segments)
+        for segment, style in self._ansi_parser.parse_ansi_colors(text):
+            color = style.get("color")
+            bold = style.get("bold", False)
+            self.text_buffer.append((segment, self.ensure_tag(color=color, bold=bold) if color or bold else ""))
+        self._schedule_flush()
+
+    def _insert_styled(self, segments):
+        """Buffer (text, style ID) segments the launcher exe has already parsed."""
+        if not (self.text_widget and self.text_widget.winfo_exists()):
+            return
 
-        # Start a flush operation if one is not already scheduled
+        for segment, style_id in segments:
+            tag = self._style_tags.get(style_id)
+            if tag is None:
+                color, bold = style_from_id(style_id)
+                tag = self.ensure_tag(color=color, bold=bold) if color or bold else ""
+                self._style_tags[style_id] = tag
+            self.text_buffer.append((segment, tag))
+        self._schedule_flush()
+
+    def _schedule_flush(self):
+        """Start a flush operation if one is not already scheduled."""
         if not self.is_flushing:
             self.is_flushing = True
             self.frame.after(50, self._flush_text_buffer)
@@ -573,6 +619,9 @@ class ScriptTab(Tab):
 
         # Insert the segments into the Text widget
         self._safe_insert_segments(segments_to_insert)
+        if self.trace_stamps:
+            self.process_tracker.latency.record(self.script_name, self.trace_stamps)
+            self.trace_stamps = []
 
         # Check if more data was added to the buffer while flushing
         if self.text_buffer:
@@ -594,20 +643,13 @@ class ScriptTab(Tab):
             return 50
 
     def _safe_insert_segments(self, segments):
-        """Safely insert text segments with colors and bold styles into the text widget."""
+        """Safely insert (text, tag) segments into the text widget with a single insert call."""
+        if not segments:
+            return
         try:
-            for segment, style in segments:
-                color = style.get("color")  # Extract the color
-                bold = style.get("bold", False)  # Extract bold
-
-                if color or bold:
-                    # Ensure the tag exists for this combination of color and bold
-                    tag = self.ensure_tag(color=color, bold=bold)
-                    self.text_widget.insert(tk.END, segment, tag)
-                else:
-                    # Insert plain text with no formatting
-                    self.text_widget.insert(tk.END, segment)
-
+            # Tk takes any number of text/tag pairs in one insert; "" inserts untagged text
+            arguments = [item for segment in segments for item in segment]
+            self.text_widget.insert(tk.END, *arguments)
             self.text_widget.see(tk.END)  # Scroll to the end
         except TclError as e:
             print(f"[WARNING] _safe_insert_segments: TclError encountered: {e}")
@@ -629,8 +671,13 @@ class ScriptTab(Tab):
         """
         Ensure that a text tag for the given color and bold style is defined in the widget.
         """
+        tag = self._tags.get((color, bold))
+        if tag is not None:
+            return tag
+
         # Generate a unique tag name based on color and bold
         tag = f"color-{color}-bold-{bold}" if color else f"bold-{bold}"
+        self._tags[(color, bold)] = tag
 
         if tag not in self.text_widget.tag_names():
             tag_config = {}
@@ -720,16 +767,31 @@ class PerfTab(Tab):
     MA_WINDOW_SEC = 2
     CALCULATED_MA_WINDOW = int((MA_WINDOW_SEC*1000) / REFRESH_RATE_MS)
 
-    def __init__(self, title, process_tracker):
+    # Interval between self-metrics queries to the launcher exe
+    LAUNCHER_METRICS_INTERVAL_MS = 1000
+
+    def __init__(self, title, process_tracker, shared_state=None, launcher_metrics=None):
         super().__init__(title)
         self.process_tracker = process_tracker
+        self.shared_state = shared_state
+        self.launcher_metrics = launcher_metrics
+        self.last_metrics_query = 0.0
         self.performance_metrics_open = True
         self.text_widget = None
         self.cpu_stats = {}
         self.process_objects = {}
+        self.last_sample_count = None  # Last launcher telemetry sample rendered
+        self.latency_overlay = None  # BooleanVar of the latency overlay toggle
 
     def build_content(self):
         """Add widgets to the performance tab."""
+        # Latency histograms cost a stamp per output frame, so they are only collected when shown
+        self.latency_overlay = tk.BooleanVar(value=False)
+        ttk.Checkbutton(
+            self.frame, text="Show output latency", variable=self.latency_overlay,
+            command=lambda: self.process_tracker.latency.set_enabled(self.latency_overlay.get())
+        ).pack(side="top", anchor="w")
+
         self.text_widget = tk.Text(
             self.frame, wrap="word",
             bg=TEXT_WIDGET_BG_COLOR, fg=TEXT_WIDGET_FG_COLOR,
@@ -743,13 +805,40 @@ class PerfTab(Tab):
         if not self.performance_metrics_open:
             return
 
-        # Update metrics
-        metrics_text = self.generate_metrics_text()
-        self.refresh_performance_metrics(metrics_text)
+        # The answer is picked up on a later refresh
+        now = time.monotonic()
+        if self.launcher_metrics and now - self.last_metrics_query >= self.LAUNCHER_METRICS_INTERVAL_MS / 1000:
+            self.last_metrics_query = now
+            self.launcher_metrics.request()
+
+        # Prefer the launcher's native telemetry - it is sampled in the exe so nothing here polls
+        telemetry = self.shared_state.telemetry() if self.shared_state else None
+        if telemetry:
+            sample_count, interval_ms, records = telemetry
+            # Only re-render when the launcher has published a new sample
+            if sample_count != self.last_sample_count:
+                self.last_sample_count = sample_count
+                self.refresh_performance_metrics(
+                    self.add_launcher_text(self.generate_native_metrics_text(records, interval_ms)))
+        else:
+            metrics_text = self.generate_metrics_text()
+            self.refresh_performance_metrics(self.add_launcher_text(metrics_text))
 
         # Schedule the next update
         self.frame.after(self.REFRESH_RATE_MS, self.start_monitoring)
 
+    def add_launcher_text(self, text):
+        """
+        Append the launcher's relay counters, if it reports them, and the latency histograms
+        when the overlay is on.
+        """
+        relay_text = self.launcher_metrics.format_text() if self.launcher_metrics else None
+        if relay_text:
+            text = f"{text}\n\n{relay_text}"
+        if self.latency_overlay is not None and self.latency_overlay.get():
+            text = f"{text}\n\n{self.process_tracker.latency.format_text()}"
+        return text
+
     def refresh_performance_metrics(self, text):
         """Refresh the performance metrics text widget."""
         if self.text_widget and self.text_widget.winfo_exists():
@@ -762,13 +851,103 @@ class PerfTab(Tab):
             # Restore previous scroll position
             self.text_widget.yview_moveto(current_yview[0])
 
+    def generate_job_text(self):
+        """Summarize the launcher's job accounting for the whole Python tree."""
+        accounting = self.shared_state.job_accounting() if self.shared_state else None
+        if not accounting:
+            return None
+
+        return (
+            f"Launcher Job (all scripts)\n"
+            f"  Active Processes: {accounting['active_processes']} "
+            f"(total started: {accounting['total_processes']})\n"
+            f"  CPU Time: user {accounting['user_time']:.1f} s, kernel {accounting['kernel_time']:.1f} s\n"
+            f"  Peak Memory: {accounting['peak_memory'] / (1024 ** 2):.2f} MB\n"
+        )
+
+    @staticmethod
+    def collect_process_tree(root_pid, records_by_pid):
+        """Return the telemetry records for a process and all of its descendants."""
+        children = {}
+        for record in records_by_pid.values():
+            children.setdefault(record["parent_pid"], []).append(record)
+
+        tree = [records_by_pid[root_pid]]
+        seen = {root_pid}  # Guards against PID reuse creating a loop
+        index = 0
+        while index < len(tree):
+            for child in children.get(tree[index]["pid"], []):
+                if child["pid"] not in seen:
+                    seen.add(child["pid"])
+                    tree.append(child)
+            index += 1
+        return tree
+
+    def generate_native_metrics_text(self, records, interval_ms):
+        """Generate metrics text from the launcher exe's telemetry records."""
+        metrics = []
+        processes = self.process_tracker.list_processes()
+
+        job_text = self.generate_job_text()
+        if job_text:
+            metrics.append(job_text)
+
+        if not processes:
+            metrics.append("No scripts are currently running.")
+            return "\n".join(metrics)
+
+        records_by_pid = {record["pid"]: record for record in records}
+        window = max(1, int((self.MA_WINDOW_SEC * 1000) / max(interval_ms, 1)))
+
+        for tab_id, process_info in processes.items():
+            process = process_info.get("process")
+            script_name = process_info.get("script_name", "Unknown")
+
+            if not process or process.pid not in records_by_pid:
+                metrics.append(f"Script: {script_name}\n  Status: Not Running\n")
+                self.cpu_stats.pop(tab_id, None)
+                continue
+
+            # Sum the script and everything it spawned
+            tree = self.collect_process_tree(process.pid, records_by_pid)
+            cpu_usage = sum(record["cpu_percent"] for record in tree)
+            memory_usage = sum(record["working_set"] for record in tree) / (1024 ** 2)
+
+            if tab_id not in self.cpu_stats:
+                self.cpu_stats[tab_id] = {
+                    "cumulative_cpu": 0.0,
+                    "count": 0,
+                    "short_ma": RingMovingAverage(window)
+                }
+
+            stats = self.cpu_stats[tab_id]
+            stats["cumulative_cpu"] += cpu_usage
+            stats["count"] += 1
+            stats["short_ma"].add(cpu_usage)
+            avg_cpu_usage = stats["cumulative_cpu"] / stats["count"]
+
+            metrics.append(
+                f"Script: {script_name}\n"
+                f"  PID: {process.pid} ({len(tree)} process{'es' if len(tree) != 1 else ''})\n"
+                f"  Current CPU Usage: {stats['short_ma'].get_average():.2f}%\n"
+                f"  Average CPU Usage: {avg_cpu_usage:.2f}%\n"
+                f"  Memory Usage: {memory_usage:.2f} MB\n"
+            )
+
+        return "\n".join(metrics)
+
     def generate_metrics_text(self):
         """Generate a text representation of performance metrics."""
         metrics = []
         processes = self.process_tracker.list_processes()
 
+        job_text = self.generate_job_text()
+        if job_text:
+            metrics.append(job_text)
+
         if not processes:
-            return "No scripts are currently running."
+            metrics.append("No scripts are currently running.")
+            return "\n".join(metrics)
 
         # Ensure cpu_stats exists for tracking cumulative CPU stats
         if not hasattr(self, 'cpu_stats'):
@@ -1281,9 +1460,11 @@ class CommandLineTab(Tab):
 
 class ScriptLauncherApp:
     """Represents the main application for launching and managing scripts."""
-    def __init__(self, root):
+    def __init__(self, root, shared_state=None, spawn_service=None, launcher_metrics=None):
         # Root Window Setup
         self.root = root
+        self.shared_state = shared_state  # Launcher exe shared state (None if run standalone)
+        self.launcher_metrics = launcher_metrics  # Launcher exe self-metrics queries (framed IPC only)
         self.configure_root()
 
         # Toolbar Setup
@@ -1295,10 +1476,15 @@ class ScriptLauncherApp:
         self.bind_events()
 
         # Event for shutdown
-        self.shutdown_event = Event()
+        self.shutdown_event = threading.Event()
+
+        # Pre-started interpreters from the launcher exe, if it runs a pool
+        self.interpreter_pool = InterpreterPool(shared_state) if shared_state else None
 
         self.process_tracker = ProcessTracker(scheduler=self.root.after,
-                                              shutdown_event=self.shutdown_event)
+                                              shutdown_event=self.shutdown_event,
+                                              interpreter_pool=self.interpreter_pool,
+                                              spawn_service=spawn_service)
 
         # Bind key press globally - for script keyboard input support
         self.root.bind("<Key>", self.on_key_press)
@@ -1397,7 +1583,9 @@ class ScriptLauncherApp:
         """Open a new performance metrics tab."""
         perf_tab = PerfTab(
             title="Performance Metrics",
-            process_tracker=self.process_tracker
+            process_tracker=self.process_tracker,
+            shared_state=self.shared_state,
+            launcher_metrics=self.launcher_metrics
         )
         self.tab_manager.add_tab(perf_tab)
 
@@ -1558,6 +1746,23 @@ class ScriptLauncherApp:
             delay = i * SCRIPT_LOAD_DELAY_MS
             self.root.after(delay, load_script_with_delay, i)
 
+    def handle_attach_request(self, request):
+        """Act on a request the launcher forwarded from a second start of the exe."""
+        if request.startswith("group "):
+            self.load_script_group_from_path(Path(request[len("group "):]))
+        elif request != "focus":
+            logger.warning("Ignoring unknown attach request: %s", request)
+        self.bring_to_front()
+
+    def bring_to_front(self):
+        """Restore the window and raise it above other applications."""
+        self.root.deiconify()
+        self.root.lift()
+        # lift() alone only reorders this app's windows
+        self.root.attributes("-topmost", True)
+        self.root.after_idle(self.root.attributes, "-topmost", False)
+        self.root.focus_force()
+
     def on_shutdown(self):
         logger.info("Shutdown signal received. Triggering shutdown_event.")
         logger.debug(f"[DEBUG] on_shutdown shutdown_event ID: {id(self.shutdown_event)}")
@@ -1599,16 +1804,29 @@ class ScriptLauncherApp:
 
 class ProcessTracker:
     """Manages runtime of collection of processes"""
-    def __init__(self, scheduler, shutdown_event):
+    def __init__(self, scheduler, shutdown_event, interpreter_pool=None, spawn_service=None):
         self.processes = {}  # Maps tab_id to process metadata
+        self.interpreter_pool = interpreter_pool  # Warm interpreters from the launcher exe (optional)
+        self.spawn_service = spawn_service  # Launcher exe starts scripts and relays output (optional)
+        self.latency = LatencyTracker()  # Pipe-to-screen latency of spawn service output (PerfTab overlay)
         self.scheduler = scheduler  # Store the scheduler
         self.script_name = None
         self.queuefull_warning_issued = False
         self.lock = Lock()
         self.shutdown_event = shutdown_event  # Store the shutdown event
 
-    def start_process(self, tab_id, command, stdout_callback, stderr_callback, script_tab, script_name=None):
-        """Start a subprocess and manage its I/O."""
+    def start_process(self, tab_id, command, stdout_callback, stderr_callback, script_tab, script_name=None,
+                      script_path=None, styled_callback=None, trace_callback=None):
+        """
+        Start a subprocess and manage its I/O. command is started by the launcher's spawn
+        service when it offers one, whose output arrives on the command pipe reader thread.
+        Otherwise scripts given by script_path are handed to a pre-started pool interpreter when
+        one is ready, or command runs as a new subprocess; both get their own reader, writer and
+        dispatcher threads. styled_callback
+        receives the output the launcher has already split into (text, style ID) segments.
+        trace_callback(stream name, sequence, qpc) receives the launcher's stamp of each output
+        frame while latency tracing is on, ahead of the frame's text.
+        """
 
         # Add Lib path
         lib_path = str((Path(__file__).resolve().parents[1] / "Lib").resolve())
@@ -1616,23 +1834,64 @@ class ProcessTracker:
         custom_env["PYTHONPATH"] = f"{lib_path};{custom_env.get('PYTHONPATH', '')}"
 
         try:
-            process = subprocess.Popen(
-                command,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                stdin=subprocess.PIPE,
-                text=True,
-                bufsize=1,
-                env=custom_env,
-            )
-            print(f"[INFO] Started process: {script_name}, PID: {process.pid}, Tab ID: {tab_id}")
+            process = None
+            service_queues = None
+            if self.spawn_service:
+                stdout_queue = CallbackQueue(lambda text: self.scheduler(0, lambda t=text: stdout_callback(t)))
+                stderr_queue = CallbackQueue(lambda text: self.scheduler(0, lambda t=text: stderr_callback(t)))
+                on_styled = None
+                if styled_callback:
+                    on_styled = lambda segments: self.scheduler(0, lambda s=segments: styled_callback(s))
+                on_trace = None
+                if trace_callback:
+                    stream_names = {STREAM_STDOUT: "stdout", STREAM_STDERR: "stderr"}
+                    def on_trace(stream, sequence, qpc):
+                        if self.latency.enabled:
+                            name = stream_names.get(stream, "?")
+                            self.scheduler(0, lambda: trace_callback(name, sequence, qpc))
+                spawned = self.spawn_service.spawn(command, stdout_queue.put, stderr_queue.put, env=custom_env,
+                                                   on_styled=on_styled, on_trace=on_trace)
+                if spawned:
+                    process, stdin_queue = spawned
+                    service_queues = (stdout_queue, stderr_queue, stdin_queue)
+                    print(f"[INFO] Started process through launcher: {script_name}, PID: {process.pid}, "
+                          f"Tab ID: {tab_id}")
+            if not process and self.interpreter_pool and script_path:
+                process = self.interpreter_pool.claim(str(script_path), env=custom_env, path=[lib_path])
+                if process:
+                    print(f"[INFO] Started process from pool: {script_name}, PID: {process.pid}, Tab ID: {tab_id}")
+            if not process:
+                process = subprocess.Popen(
+                    command,
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.PIPE,
+                    stdin=subprocess.PIPE,
+                    text=True,
+                    bufsize=1,
+                    env=custom_env,
+                )
+                print(f"[INFO] Started process: {script_name}, PID: {process.pid}, Tab ID: {tab_id}")
+
+            # Put the script in its own job so its whole tree can be killed in one call
+            job = None
+            try:
+                job = JobObject()
+                job.assign(process.pid)
+            except OSError as e:
+                print(f"[WARNING] Could not create job object for {script_name}: {e}")
+                if job:
+                    job.close()
+                job = None
 
             self.script_name = script_name
 
             # Create individual queues and stop event
-            stdout_queue = queue.Queue(maxsize=1000)
-            stderr_queue = queue.Queue(maxsize=1000)
-            stdin_queue = queue.Queue(maxsize=1000)
+            if service_queues:
+                stdout_queue, stderr_queue, stdin_queue = service_queues
+            else:
+                stdout_queue = queue.Queue(maxsize=1000)
+                stderr_queue = queue.Queue(maxsize=1000)
+                stdin_queue = queue.Queue(maxsize=1000)
             stop_event = threading.Event()
 
             with self.lock:
@@ -1644,8 +1903,14 @@ class ProcessTracker:
                     "stderr_queue": stderr_queue,
                     "stdin_queue": stdin_queue,
                     "stop_event": stop_event,
+                    "job": job,
                 }
 
+            # The launcher relays the output of spawned scripts, only the exit check is needed
+            if service_queues:
+                self.schedule_process_check(tab_id)
+                return
+
             # Start threads for stdout and stderr reading
             threading.Thread(
                 target=self._read_output,
@@ -1718,13 +1983,14 @@ class ProcessTracker:
                     # Process complete lines in the buffer
                     while "\n" in buffer:
                         line, buffer = buffer.split("\n", 1)
-                        output_queue.put_nowait(line + "\n")
+                        if not self._put_output(output_queue, line + "\n", stop_event):
+                            break
                         #print(f"[DEBUG] Line enqueued: {repr(line)}")
                         last_flushed_partial = None  # Reset partial tracking
 
                     # Handle partial line (e.g., prompts or incomplete output)
                     if buffer and buffer != last_flushed_partial:
-                        output_queue.put_nowait(buffer)
+                        self._put_output(output_queue, buffer, stop_event)
                         #print(f"[DEBUG] Partial buffer enqueued: {repr(buffer)}")
                         last_flushed_partial = buffer
 
@@ -1746,7 +2012,7 @@ class ProcessTracker:
         finally:
             # Handle cleanup: flush remaining buffer and signal end of stream
             if buffer and buffer != last_flushed_partial:
-                output_queue.put_nowait(buffer)
+                self._put_output(output_queue, buffer, stop_event)
                 print(f"[DEBUG] Final buffer flushed: {repr(buffer)}")
             output_queue.put(None)  # Signal end of stream to the queue
 
@@ -1757,6 +2023,21 @@ class ProcessTracker:
 
             print(f"[INFO] Output reader for {stream_name} finished, Tab ID: {tab_id}")
 
+    @staticmethod
+    def _put_output(output_queue, text, stop_event):
+        """
+        Queue output for the dispatcher, waiting while the queue is full. The reader stops
+        reading meanwhile, so a flooding script blocks on its own pipe instead of the UI
+        falling behind. Returns False if the process was stopped while waiting.
+        """
+        while not stop_event.is_set():
+            try:
+                output_queue.put(text, timeout=0.5)
+                return True
+            except queue.Full:
+                continue
+        return False
+
     def _write_input(self, stdin, input_queue, stop_event, tab_id):
         """Write input from the queue to the subprocess's stdin."""
         try:
@@ -1835,9 +2116,11 @@ class ProcessTracker:
                         self.scheduler(SCRIPT_LOAD_DELAY_MS,
                                        lambda: script_tab.reload_script(clear_text=False))
 
-                # Clean up process metadata
+                # Clean up process metadata, closing the job kills any children left behind
                 with self.lock:
                     self.processes.pop(tab_id, None)
+                if metadata.get("job"):
+                    metadata["job"].close()
             except Exception as e:
                 print(f"[ERROR] Error notifying ScriptTab for Tab ID {tab_id}: {e}")
             return
@@ -1859,7 +2142,13 @@ class ProcessTracker:
             process = metadata["process"]
 
         # Terminate the process if it is still running
-        if process.poll() is None:  # Still running
+        job = metadata.get("job")
+        if job:
+            # One call kills the script and everything it spawned
+            print(f"[INFO] Terminating job for Tab ID {tab_id} (PID {process.pid}).")
+            job.terminate()
+            job.close()
+        elif process.poll() is None:  # Still running
             print(f"[INFO] Terminating process for Tab ID {tab_id} (PID {process.pid}).")
             self.terminate_process_tree(process.pid)
 
@@ -1888,7 +2177,7 @@ class ProcessTracker:
             logger.info(f"Process with PID {pid} already terminated. "
                   "Checking for orphaned children.")
             # Attempt to clean up orphaned child processes
-            self.terminate_orphaned_children(pid)
+            ProcessTracker.terminate_orphaned_children(pid)
             return
         except Exception as e:
             print(f"[ERROR] Failed to initialize process PID {pid}: {e}")
@@ -1992,57 +2281,134 @@ class RingMovingAverage:
         """Get calculated average"""
         return np.mean(self.buffer[:self.count]) if self.count > 0 else 0.0
 
-def monitor_shutdown_pipe(pipe_name, shutdown_event):
-    """Monitor the named pipe for shutdown signals and heartbeats."""
-    logger.info("Monitoring shutdown pipe in subprocess. Pipe: %s", pipe_name)
-
-    HEARTBEAT_TIMEOUT = 5  # Timeout in seconds to detect missed heartbeats
-    last_heartbeat_time = time.time()  # Track the last heartbeat time
+# Access right needed to change a named pipe client's read mode
+FILE_WRITE_ATTRIBUTES = 0x0100
+
+def read_pipe_messages(pipe_name, stop_event, max_message_size=4096, strip=True):
+    """
+    Yield whole messages from a message-mode named pipe created by the launcher exe.
+    Each read returns exactly one message so no line splitting is needed. With strip=False
+    the raw bytes are yielded (used for framed commands).
+    """
+    import _winapi
+
+    handle = _winapi.CreateFile(
+        pipe_name,
+        _winapi.GENERIC_READ | FILE_WRITE_ATTRIBUTES,  # Write attributes to set the read mode
+        0, _winapi.NULL, _winapi.OPEN_EXISTING, 0, _winapi.NULL
+    )
+    try:
+        _winapi.SetNamedPipeHandleState(handle, _winapi.PIPE_READMODE_MESSAGE, None, None)
+        while not stop_event.is_set():
+            data, error = _winapi.ReadFile(handle, max_message_size)
+            if error == _winapi.ERROR_MORE_DATA:
+                # Oversized message - collect the remainder so framing is preserved
+                remainder = _winapi.PeekNamedPipe(handle)[1]  # Bytes left in this message
+                data += _winapi.ReadFile(handle, remainder)[0]
+            if not data:
+                break
+            yield data.decode("utf-8").strip() if strip else data
+    finally:
+        _winapi.CloseHandle(handle)
+
+def read_pipe_frames(pipe_name, stop_event, message_mode=False):
+    """
+    Yield (channel, payload) for the control and spawn service frames sent by the launcher exe
+    over the command pipe.
+    """
+    decoder = FrameDecoder()
+
+    if message_mode:
+        for chunk in read_pipe_messages(pipe_name, stop_event, strip=False):
+            for channel, payload in decoder.feed(chunk):
+                if channel in (CHANNEL_CONTROL, CHANNEL_SPAWN):
+                    yield channel, payload
+        return
+
+    with open(pipe_name, "rb", buffering=0) as pipe:
+        while not stop_event.is_set():
+            chunk = pipe.read(65536)  # Also carries the output of spawned scripts
+            if not chunk:
+                break
+            for channel, payload in decoder.feed(chunk):
+                if channel in (CHANNEL_CONTROL, CHANNEL_SPAWN):
+                    yield channel, payload
+
+def monitor_command_pipe(pipe_name, shutdown_event, message_mode=False, framed=False, spawn_service=None,
+                         launcher_metrics=None, on_attach=None):
+    """
+    Read commands (such as shutdown) sent by the launcher exe over the command pipe. With the
+    spawn service this thread also delivers the output of every script it started, and with
+    framing the answers to self-metrics queries. "attach <request>" commands carry the request
+    of a second start of the exe and are passed to on_attach.
+    """
+    logger.info("Monitoring command pipe. Pipe: %s (message mode: %s, framed: %s)",
+                pipe_name, message_mode, framed)
+
+    def handle_command(line):
+        """Handle one command from the launcher. Returns False to stop reading."""
+        if line == "shutdown":
+            logger.info("Shutdown signal received on command pipe.")
+            shutdown_event.set()
+            return False
+        if launcher_metrics and LauncherMetrics.is_reply(line):
+            launcher_metrics.handle_reply(line)
+        elif on_attach and line.startswith(ATTACH_COMMAND_PREFIX):
+            on_attach(line[len(ATTACH_COMMAND_PREFIX):])
+        return True
 
-    def pipe_reader():
-            """Threaded pipe reader."""
-            nonlocal last_heartbeat_time
-            try:
-                with open(pipe_name, "r", encoding="utf-8") as pipe:
-                    logger.info("Successfully connected to the shutdown pipe.")
-                    while not shutdown_event.is_set():
-                        try:
-                            # Read line from pipe (blocking)
-                            line = pipe.readline().strip()
-                            if line:
-                                if line == "shutdown":
-                                    logger.info("Shutdown signal received in subprocess.")
-                                    shutdown_event.set()
-                                    break
-                                elif line == "HEARTBEAT":
-                                    #logging.debug("Heartbeat received.")
-                                    last_heartbeat_time = time.time()  # Update last heartbeat time
-                        except Exception as e:
-                            logger.error("Exception while reading pipe: %s", e)
-                            break
+    try:
+        if framed:
+            # Each control frame carries one whole command
+            logger.info("Successfully connected to the command pipe.")
+            for channel, payload in read_pipe_frames(pipe_name, shutdown_event, message_mode):
+                if channel == CHANNEL_SPAWN:
+                    if spawn_service:
+                        spawn_service.handle_frame(payload)
+                elif not handle_command(payload.decode("utf-8")):
+                    break
+            return
 
-                        # Sleep briefly to prevent tight loop
-                        time.sleep(0.1)
-            except Exception as e:
-                logger.error("Failed to monitor shutdown pipe: %s", e)
-            finally:
-                logger.info("Exiting pipe_reader thread.")
-
-    # Start the reader thread
-    reader_thread = threading.Thread(target=pipe_reader, daemon=True)
-    reader_thread.start()
-
-    # Wait for shutdown event while pipe read runs in thread
-    while not shutdown_event.is_set():
-        # Check for heartbeat timeout
-        if time.time() - last_heartbeat_time > HEARTBEAT_TIMEOUT:
-            logger.info("!=================== Heartbeat timeout detected ===================!")
-            shutdown_event.set()
-            break
-        time.sleep(0.5)
+        if message_mode:
+            # Blocking reads return one whole command each
+            logger.info("Successfully connected to the command pipe.")
+            for line in read_pipe_messages(pipe_name, shutdown_event):
+                if line and not handle_command(line):
+                    break
+            return
 
-    logger.debug("join reader_thread")
-    reader_thread.join(timeout=1)  # Allow the thread to exit
+        with open(pipe_name, "r", encoding="utf-8") as pipe:
+            logger.info("Successfully connected to the command pipe.")
+            while not shutdown_event.is_set():
+                # Read line from pipe (blocking), empty string means the launcher closed it
+                line = pipe.readline()
+                if not line:
+                    break
+                if not handle_command(line.strip()):
+                    break
+    except Exception as e:
+        logger.error("Failed to monitor command pipe: %s", e)
+    finally:
+        logger.info("Exiting command pipe reader.")
+
+def monitor_spawn_ring(reader, shutdown_event, spawn_service):
+    """
+    Deliver the spawn service records the launcher writes to the shared-memory ring. Replaces
+    the spawn frames of the command pipe, which then only carries commands.
+    """
+    logger.info("Monitoring spawn ring. Ring: %s (%d bytes)", reader.name, reader.capacity)
+    try:
+        while not shutdown_event.is_set():
+            payloads = reader.read_batch()
+            for payload in payloads:
+                spawn_service.handle_frame(payload)
+            if not payloads:
+                reader.wait(SPAWN_RING_WAIT)
+    except Exception as e:
+        logger.error("Failed to read spawn ring: %s", e)
+    finally:
+        reader.close()
+        logger.info("Exiting spawn ring reader.")
 
 def is_shift_held():
     """Check if Shift key is currently held globally."""
@@ -2066,6 +2432,45 @@ def main():
     else:
         logger.info("No --shutdown-pipe argument provided. Skipping pipe-based shutdown logic.")
 
+    # Commands arrive as whole pipe messages when the launcher runs the pipe in message mode
+    command_message_mode = "--command-message-mode" in args
+
+    # Frame stdout/stderr (and read framed commands) when the launcher asks for it
+    framed_ipc = "--framed-ipc" in args
+    if framed_ipc:
+        install_framed_stdio()
+
+    # The launcher starts scripts and relays their output when it offers the spawn service
+    spawn_service = None
+    if "--spawn-service" in args and framed_ipc and hasattr(sys.stdout, "write_frame"):
+        spawn_service = SpawnService(sys.stdout.write_frame)
+        logger.info("Using the launcher's spawn service for scripts.")
+
+    # The launcher answers self-metrics queries as control frames on the command pipe
+    launcher_metrics = None
+    if framed_ipc and hasattr(sys.stdout, "write_frame"):
+        launcher_metrics = LauncherMetrics(sys.stdout.write_frame)
+
+    # Spawn service replies come through a shared-memory ring when the launcher created one
+    spawn_ring = None
+    if spawn_service and "--spawn-ring" in args:
+        spawn_ring_name = args[args.index("--spawn-ring") + 1]
+        try:
+            spawn_ring = ShmRingReader(spawn_ring_name)
+        except (OSError, ValueError) as e:
+            logger.error("Failed to open spawn ring '%s': %s", spawn_ring_name, e)
+
+    # Parse the --shared-memory argument (heartbeat counter and shutdown flag)
+    shared_state = None
+    if "--shared-memory" in args:
+        shared_memory_name = args[args.index("--shared-memory") + 1]
+        try:
+            shared_state = SharedLauncherState(shared_memory_name)
+            logger.debug("shared_memory=%s version=%s", shared_memory_name, shared_state.version)
+            shared_state.mark_ui_main()
+        except (OSError, ValueError) as e:
+            logger.error("Failed to open shared state block '%s': %s", shared_memory_name, e)
+
     # Add lib_path to PYTHONPATH
     lib_path = str((Path(__file__).resolve().parents[1] / "Lib").resolve())
     if lib_path not in os.environ.get("PYTHONPATH", "").split(";"):
@@ -2078,7 +2483,8 @@ def main():
 
     # Start app
     root = ThemedTk(theme="black")
-    app = ScriptLauncherApp(root)
+    app = ScriptLauncherApp(root, shared_state=shared_state, spawn_service=spawn_service,
+                            launcher_metrics=launcher_metrics)
 
     # Add fault handler
     faulthandler.enable()
@@ -2090,17 +2496,33 @@ def main():
 
     #reset_traceback_timer()
 
-    # Start the shutdown monitoring subprocess if a pipe is provided
-    monitor_process = None
+    # Read launcher commands on a background thread if a pipe is provided
     if shutdown_pipe:
-        monitor_process = Process(target=monitor_shutdown_pipe,
-                                  args=(shutdown_pipe, app.shutdown_event))
-        monitor_process.start()
-        logger.info("Started shutdown monitoring process.")
+        def on_attach(request):
+            root.after(0, app.handle_attach_request, request)
+        threading.Thread(target=monitor_command_pipe,
+                         args=(shutdown_pipe, app.shutdown_event, command_message_mode, framed_ipc,
+                               spawn_service, launcher_metrics, on_attach),
+                         daemon=True, name="CommandPipeReader").start()
+        logger.info("Started command pipe reader thread.")
+
+    if spawn_ring:
+        threading.Thread(target=monitor_spawn_ring, args=(spawn_ring, app.shutdown_event, spawn_service),
+                         daemon=True, name="SpawnRingReader").start()
 
     try:
-        # Periodically check for the shutdown_event
+        # Periodically check for the shutdown_event and the launcher's shared state
         def check_shutdown():
+            if shared_state:
+                shared_state.beat_ui()  # Lets the launcher detect a hung Tk loop
+            if shared_state and not app.shutdown_event.is_set():
+                if shared_state.shutdown_requested:
+                    logger.info("Shutdown requested through shared state.")
+                    app.shutdown_event.set()
+                elif shared_state.seconds_since_heartbeat() > HEARTBEAT_TIMEOUT:
+                    logger.info("!=================== Heartbeat timeout detected ===================!")
+                    app.shutdown_event.set()
+
             if app.shutdown_event.is_set():
                 logger.info("Shutdown event detected in main application.")
                 app.on_close()
@@ -2112,21 +2534,19 @@ def main():
         DarkmodeUtils.apply_dark_mode(root)
 
         app.start()
+
+        # Idle callbacks run once the pending redraws are done, i.e. after the first frame
+        if shared_state:
+            root.after_idle(shared_state.mark_first_frame)
         root.mainloop()
 
         logger.info("Tkinter main loop has exited.")
     finally:
         logger.info("Finalizing application shutdown...")
 
-        # Ensure subprocess cleanup
-        if monitor_process:
-            app.shutdown_event.set()  # Ensure the subprocess knows to exit
-            logger.debug("Waiting for shutdown monitoring process to exit...")
-            monitor_process.join(timeout=5)
-            logger.debug("Past monitor_process join")
-            if monitor_process.is_alive():
-                logger.warning("Forcibly terminating the shutdown monitoring process.")
-                monitor_process.terminate()
+        if shared_state:
+            shared_state.acknowledge_shutdown()
+            shared_state.close()
 
         logger.info("Application closed successfully.")
         logger.stop()
@@ -1,10 +1,17 @@
+import ctypes
+import mmap
 import psutil
+import struct
+import sys
 import threading
 import random
 import time
 import socket
 from pathlib import Path
 from Launcher import ScriptLauncherApp, ScriptTab
+from launcher_ipc import CHANNEL_LOG, CHANNEL_SPAWN, FRAME_HEADER, FRAME_MAGIC, FrameDecoder, encode_frame
+from shm_ring import HEADER_SIZE, OFFSET_CONSUMER_WAITING, OFFSET_READ_POS, OFFSET_WRITE_POS, ShmRingReader
+from spawn_service import RUN_FORMAT, STREAM_STDERR, STREAM_STDOUT, SpawnService, _Script
 import tkinter as tk
 
 def get_python_pids():
@@ -162,6 +169,107 @@ def fuzz_test_launcher(scripts_dir, server_address=("127.0.0.1", 65432), duratio
     threading.Thread(target=start_fuzz_test, daemon=True).start()
     root.mainloop()
 
+def test_frame_decoder_split_frames():
+    """Frames fed one byte at a time come out whole and in order."""
+    data = encode_frame(CHANNEL_LOG, b"hello\n") + encode_frame(CHANNEL_SPAWN, b"started 1 42")
+    decoder = FrameDecoder()
+    frames = []
+    for i in range(len(data)):
+        frames += decoder.feed(data[i:i + 1])
+    assert frames == [(CHANNEL_LOG, b"hello\n"), (CHANNEL_SPAWN, b"started 1 42")]
+
+def test_frame_decoder_resync():
+    """Unframed bytes, a stray magic byte and a bad header pass through as log output."""
+    bad_header = FRAME_HEADER.pack(FRAME_MAGIC, 99, 0, 3)
+    garbage = b"C-level \x1e text" + bad_header
+    decoder = FrameDecoder()
+    frames = decoder.feed(garbage + encode_frame(CHANNEL_SPAWN, b"exited 1 0"))
+    assert b"".join(payload for channel, payload in frames if channel == CHANNEL_LOG) == garbage
+    assert [frame for frame in frames if frame[0] == CHANNEL_SPAWN] == [(CHANNEL_SPAWN, b"exited 1 0")]
+
+def make_test_ring(capacity):
+    """A ring reader over an anonymous mapping, without the launcher's named mapping and event."""
+    reader = ShmRingReader.__new__(ShmRingReader)
+    reader.name = "test"
+    reader.capacity = capacity
+    reader._data_offset = HEADER_SIZE
+    reader._map = mmap.mmap(-1, HEADER_SIZE + capacity)
+    reader._write_pos = ctypes.c_int64.from_buffer(reader._map, OFFSET_WRITE_POS)
+    reader._read_pos = ctypes.c_int64.from_buffer(reader._map, OFFSET_READ_POS)
+    reader._waiting = ctypes.c_int32.from_buffer(reader._map, OFFSET_CONSUMER_WAITING)
+    reader._event = None
+    return reader
+
+def write_test_record(reader, payload):
+    """Publish a record the way ShmRing.c does: length, payload, padded to 4 bytes, wrapping."""
+    position = reader._write_pos.value
+    record = struct.pack("<I", len(payload)) + payload
+    for i, byte in enumerate(record):
+        reader._map[reader._data_offset + ((position + i) & (reader.capacity - 1))] = byte
+    reader._write_pos.value = position + ((len(record) + 3) & ~3)
+
+def test_shm_ring_wrap():
+    """Records, lengths included, are read back whole across the end of the data area."""
+    reader = make_test_ring(64)
+    try:
+        for round_index in range(8):
+            payloads = [f"record {round_index}-{i} ".encode() * (i + 1) for i in range(2)]
+            for payload in payloads:
+                write_test_record(reader, payload)
+            assert reader.pending()
+            assert reader.read_batch() == payloads
+            assert not reader.pending()
+    finally:
+        reader.close()
+
+def add_test_script(service, script_id, on_stdout, on_stderr, on_styled=None):
+    """Register a script as if the launcher had started it."""
+    script = _Script(on_stdout, on_stderr, on_styled, None)
+    script.pid = 1
+    script.started.set()
+    service._scripts[script_id] = script
+    return script
+
+def styled_frame(script_id, stream, runs, text, sequence):
+    """A "styled" reply as SpawnService.c sends it."""
+    header = f"styled {script_id} {stream} {len(runs)} {sequence} 0\n".encode("ascii")
+    return header + b"".join(RUN_FORMAT.pack(*run) for run in runs) + text
+
+def test_spawn_styled_runs_across_utf8_boundaries():
+    """A character split across runs and frames ends up in the run holding its last byte."""
+    service = SpawnService(lambda channel, payload: None)
+    styled = []
+    add_test_script(service, 1, None, None, on_styled=styled.append)
+
+    # "é" is C3 A9; the first frame ends after C3
+    service.handle_frame(styled_frame(1, STREAM_STDOUT, [(0, 2, 1), (2, 1, 2)], b"ab\xc3", 1))
+    service.handle_frame(styled_frame(1, STREAM_STDOUT, [(0, 1, 2), (1, 2, 3)], b"\xa9cd", 2))
+    assert styled == [[("ab", 1)], [("\u00e9", 2), ("cd", 3)]]
+
+def test_spawn_exited_flushes_decoders():
+    """"exited" delivers a trailing partial character and drops the script."""
+    service = SpawnService(lambda channel, payload: None)
+    stdout, stderr = [], []
+    add_test_script(service, 1, stdout.append, stderr.append)
+
+    service.handle_frame(b"out 1 1 1 0\nx\xe2\x82")
+    service.handle_frame(f"out 1 {STREAM_STDERR} 1 0\n".encode("ascii") + b"err")
+    service.handle_frame(b"exited 1 0")
+    service.handle_frame(b"out 1 1 2 0\nlate")
+    assert stdout == ["x", "\ufffd"]
+    assert stderr == ["err"]
+    assert 1 not in service._scripts
+
+def run_unit_tests():
+    """Run the test_* functions of this file."""
+    tests = [value for name, value in sorted(globals().items()) if name.startswith("test_") and callable(value)]
+    for test in tests:
+        test()
+        print(f"[TEST] {test.__name__} passed")
+
 if __name__ == "__main__":
-    scripts_dir = Path(__file__).resolve().parent / "Scripts"
-    fuzz_test_launcher(scripts_dir, duration=30)
+    if "--unit" in sys.argv:
+        run_unit_tests()
+    else:
+        scripts_dir = Path(__file__).resolve().parent / "Scripts"
+        fuzz_test_launcher(scripts_dir, duration=30)
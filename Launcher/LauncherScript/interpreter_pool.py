@@ -0,0 +1,116 @@
+# interpreter_pool.py - hands scripts to the pre-started interpreters of the launcher exe.
+#   The pool table lives in the shared state block (PoolTable in InterpreterPool.h); each
+#   ready slot holds a parked pool_worker.py process and pipe handles already owned by this
+#   process. Claiming a slot returns a PooledProcess, which behaves enough like
+#   subprocess.Popen for ProcessTracker.
+
+import ctypes
+import io
+import json
+import msvcrt
+import os
+import _winapi
+from ctypes import wintypes
+
+POOL_SLOT_EMPTY = 0
+POOL_SLOT_READY = 1
+POOL_SLOT_CLAIMED = 2
+
+kernel32 = ctypes.WinDLL("kernel32", use_last_error=True)
+kernel32.OpenEventW.restype = wintypes.HANDLE
+kernel32.OpenEventW.argtypes = [wintypes.DWORD, wintypes.BOOL, wintypes.LPCWSTR]
+kernel32.SetEvent.restype = wintypes.BOOL
+kernel32.SetEvent.argtypes = [wintypes.HANDLE]
+kernel32.CloseHandle.restype = wintypes.BOOL
+kernel32.CloseHandle.argtypes = [wintypes.HANDLE]
+
+EVENT_MODIFY_STATE = 0x0002
+PROCESS_SYNCHRONIZE_QUERY = 0x00100000 | 0x1000 | 0x0001  # SYNCHRONIZE, QUERY_LIMITED_INFORMATION, TERMINATE
+STILL_ACTIVE = 259
+
+class PooledProcess:
+    """A claimed pool worker, exposing the parts of subprocess.Popen used by ProcessTracker."""
+    def __init__(self, pid, stdin_handle, stdout_handle, stderr_handle):
+        self.pid = pid
+        self.args = None
+        self.returncode = None
+        self._handle = _winapi.OpenProcess(PROCESS_SYNCHRONIZE_QUERY, False, pid)
+
+        # Text stdin and raw stdout/stderr, matching Popen(text=True, bufsize=1) as ProcessTracker reads by fd
+        self.stdin = io.TextIOWrapper(
+            io.open(msvcrt.open_osfhandle(stdin_handle, os.O_WRONLY), "wb", buffering=0),
+            encoding="utf-8", write_through=True, line_buffering=True)
+        self.stdout = io.open(msvcrt.open_osfhandle(stdout_handle, os.O_RDONLY), "rb", buffering=0)
+        self.stderr = io.open(msvcrt.open_osfhandle(stderr_handle, os.O_RDONLY), "rb", buffering=0)
+
+    def poll(self):
+        """Return the exit code, or None while the worker is running."""
+        if self.returncode is None:
+            code = _winapi.GetExitCodeProcess(self._handle)
+            if code != STILL_ACTIVE or _winapi.WaitForSingleObject(self._handle, 0) == _winapi.WAIT_OBJECT_0:
+                self.returncode = code
+        return self.returncode
+
+    def wait(self, timeout=None):
+        """Wait for the worker to exit and return its exit code."""
+        milliseconds = _winapi.INFINITE if timeout is None else int(timeout * 1000)
+        if _winapi.WaitForSingleObject(self._handle, milliseconds) != _winapi.WAIT_OBJECT_0:
+            raise TimeoutError(f"Process {self.pid} did not exit within {timeout} seconds")
+        return self.poll()
+
+    def terminate(self):
+        """Terminate the worker if it is still running."""
+        if self.poll() is None:
+            _winapi.TerminateProcess(self._handle, 1)
+
+    kill = terminate
+
+class InterpreterPool:
+    """Claims parked interpreters from the pool table in the launcher's shared state block."""
+    def __init__(self, shared_state):
+        self.shared_state = shared_state
+        self._event = None
+
+    @property
+    def available(self):
+        """True while at least one worker is ready."""
+        return any(state == POOL_SLOT_READY for state, *_ in self.shared_state.pool_slots())
+
+    def claim(self, script, args=(), env=None, path=(), cwd=None):
+        """
+        Start a script in a parked interpreter. Returns a PooledProcess, or None if no worker
+        is ready (the caller then starts the script with subprocess as before).
+        """
+        for index, (state, pid, stdin_handle, stdout_handle, stderr_handle) in enumerate(
+                self.shared_state.pool_slots()):
+            if state != POOL_SLOT_READY:
+                continue
+
+            # Only this process moves READY -> CLAIMED, the launcher refills afterwards
+            self.shared_state.set_pool_slot_state(index, POOL_SLOT_CLAIMED)
+            self._signal_launcher()
+
+            try:
+                process = PooledProcess(pid, stdin_handle, stdout_handle, stderr_handle)
+                request = {"script": script, "args": list(args), "env": env or {},
+                           "path": list(path), "cwd": cwd}
+                process.stdin.write(json.dumps(request) + "\n")
+                return process
+            except OSError as e:
+                print(f"[WARNING] Failed to hand script to pool worker {pid}: {e}")
+                return None
+        return None
+
+    def _signal_launcher(self):
+        """Tell the launcher a slot was claimed so it starts a replacement."""
+        if self._event is None:
+            name = self.shared_state.pool_claim_event_name()
+            self._event = kernel32.OpenEventW(EVENT_MODIFY_STATE, False, name) if name else 0
+        if self._event:
+            kernel32.SetEvent(self._event)
+
+    def close(self):
+        """Release the claim event handle."""
+        if self._event:
+            kernel32.CloseHandle(self._event)
+            self._event = None
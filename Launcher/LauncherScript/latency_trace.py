@@ -0,0 +1,94 @@
+# latency_trace.py - pipe-to-screen latency histograms of script output.
+#   The launcher's spawn service stamps each output frame with the QueryPerformanceCounter value
+#   of the pipe read it arrived in and a per-stream sequence number (see SpawnService.h). The
+#   stamp is compared with the counter when the text is inserted into its tab.
+
+import ctypes
+
+# Upper bounds (ms) of the histogram buckets; the last bucket takes everything slower
+BUCKET_LIMITS_MS = (1, 2, 5, 10, 20, 50, 100, 200, 500, 1000)
+BUCKET_LABELS = [f"<{limit} ms" for limit in BUCKET_LIMITS_MS] + [f">={BUCKET_LIMITS_MS[-1]} ms"]
+
+# Width of the longest histogram bar in characters
+BAR_WIDTH = 40
+
+def query_performance_counter():
+    """Current QueryPerformanceCounter value, the time base of the launcher's stamps."""
+    counter = ctypes.c_longlong()
+    ctypes.windll.kernel32.QueryPerformanceCounter(ctypes.byref(counter))
+    return counter.value
+
+def query_performance_frequency():
+    frequency = ctypes.c_longlong()
+    ctypes.windll.kernel32.QueryPerformanceFrequency(ctypes.byref(frequency))
+    return frequency.value
+
+class StreamLatency:
+    """Histogram and sequence tracking of one script stream."""
+    def __init__(self):
+        self.buckets = [0] * len(BUCKET_LABELS)
+        self.count = 0
+        self.total_ms = 0.0
+        self.max_ms = 0.0
+        self.last_sequence = None
+        self.lost_frames = 0
+
+    def add(self, sequence, latency_ms):
+        if self.last_sequence is not None and sequence > self.last_sequence + 1:
+            self.lost_frames += sequence - self.last_sequence - 1
+        self.last_sequence = sequence
+
+        index = 0
+        while index < len(BUCKET_LIMITS_MS) and latency_ms >= BUCKET_LIMITS_MS[index]:
+            index += 1
+        self.buckets[index] += 1
+        self.count += 1
+        self.total_ms += latency_ms
+        self.max_ms = max(self.max_ms, latency_ms)
+
+class LatencyTracker:
+    """
+    Collects per-stream latency samples while enabled. Used on the Tk thread only, apart from
+    the enabled flag, which the command pipe reader checks before scheduling any stamps.
+    """
+    def __init__(self):
+        self.enabled = False
+        self._frequency = None
+        self._streams = {}  # (script name, stream name) -> StreamLatency
+
+    def set_enabled(self, enabled):
+        """Start or stop collecting; starting clears the previous samples."""
+        if enabled and not self.enabled:
+            self._streams.clear()
+            if self._frequency is None:
+                self._frequency = query_performance_frequency()
+        self.enabled = enabled
+
+    def record(self, script_name, stamps):
+        """Record (stream name, sequence, QPC) stamps whose output has just been inserted."""
+        if not self.enabled or not stamps:
+            return
+        now = query_performance_counter()
+        for stream_name, sequence, qpc in stamps:
+            stream = self._streams.get((script_name, stream_name))
+            if stream is None:
+                stream = self._streams[(script_name, stream_name)] = StreamLatency()
+            stream.add(sequence, max(0, now - qpc) * 1000.0 / self._frequency)
+
+    def format_text(self):
+        """Render every stream's histogram for the performance tab."""
+        lines = ["Output Latency (pipe read to tab insert)"]
+        if not self._streams:
+            lines.append("  No output from scripts started by the launcher yet.")
+            return "\n".join(lines) + "\n"
+
+        for (script_name, stream_name), stream in sorted(self._streams.items()):
+            lines.append(f"  {script_name} [{stream_name}]: {stream.count} frames, "
+                         f"mean {stream.total_ms / stream.count:.1f} ms, max {stream.max_ms:.1f} ms, "
+                         f"lost {stream.lost_frames}")
+            peak = max(stream.buckets)
+            for label, count in zip(BUCKET_LABELS, stream.buckets):
+                if count:
+                    bar = "#" * max(1, count * BAR_WIDTH // peak)
+                    lines.append(f"    {label:>9} {bar} {count}")
+        return "\n".join(lines) + "\n"
@@ -0,0 +1,136 @@
+# launcher_ipc.py - length-prefixed frames exchanged with the launcher exe.
+#   Mirrors Launcher/LauncherApp/Source/Ipc.h. Each frame is an 8 byte header
+#   (magic 0x1E 0xF5, channel, flags, payload length) followed by the payload. Bytes outside
+#   frames are passed through as log output, so C-level writes to stdout are not lost.
+
+import io
+import os
+import struct
+import threading
+
+FRAME_MAGIC = 0xF51E
+FRAME_HEADER = struct.Struct("<HBBI")  # magic, channel, flags, payload length
+MAX_PAYLOAD = 65536
+
+CHANNEL_LOG = 1        # stdout text
+CHANNEL_STDERR = 2     # stderr text
+CHANNEL_TELEMETRY = 3  # Reserved for telemetry records
+CHANNEL_CONTROL = 4    # Commands such as "shutdown"
+CHANNEL_SPAWN = 5      # Spawn service requests and script output (spawn_service.py)
+CHANNEL_MAX = CHANNEL_SPAWN
+
+_MAGIC_BYTES = struct.pack("<H", FRAME_MAGIC)
+
+def encode_frame(channel, payload):
+    """Return one frame carrying payload (bytes) on channel."""
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError(f"Frame payload too large: {len(payload)} bytes")
+    return FRAME_HEADER.pack(FRAME_MAGIC, channel, 0, len(payload)) + payload
+
+class FrameDecoder:
+    """Incremental decoder; feed() returns the (channel, payload) pairs completed so far."""
+    def __init__(self):
+        self._buffer = bytearray()
+
+    def feed(self, data):
+        self._buffer += data
+        buffer = self._buffer
+        frames = []
+        pos = 0
+
+        while pos < len(buffer):
+            available = len(buffer) - pos
+            if buffer[pos] == _MAGIC_BYTES[0] and (available < 2 or buffer[pos + 1] == _MAGIC_BYTES[1]):
+                # Possible frame: wait for the header, then for the payload
+                if available < FRAME_HEADER.size:
+                    break
+                magic, channel, flags, length = FRAME_HEADER.unpack_from(buffer, pos)
+                if 1 <= channel <= CHANNEL_MAX and flags == 0 and length <= MAX_PAYLOAD:
+                    end = pos + FRAME_HEADER.size + length
+                    if end > len(buffer):
+                        break
+                    frames.append((channel, bytes(buffer[pos + FRAME_HEADER.size:end])))
+                    pos = end
+                    continue
+
+            # Unframed bytes run up to the next possible frame start
+            end = buffer.find(_MAGIC_BYTES[0:1], pos + 1)
+            end = len(buffer) if end < 0 else end
+            frames.append((CHANNEL_LOG, bytes(buffer[pos:end])))
+            pos = end
+
+        del buffer[:pos]
+        return frames
+
+class FramedTextStream(io.TextIOBase):
+    """
+    Text stream that writes each line (or flush) as a frame on one channel of a file descriptor.
+    Used in place of sys.stdout and sys.stderr so the launcher can tell the streams apart.
+    """
+    def __init__(self, fd, channel, lock, encoding="utf-8"):
+        super().__init__()
+        self._fd = fd
+        self._channel = channel
+        self._lock = lock  # Shared by all streams on the same descriptor so frames never interleave
+        self._encoding = encoding
+        self._pending = []
+        self._pending_lock = threading.Lock()  # Guards _pending and keeps this stream's frames in order
+
+    @property
+    def encoding(self):
+        return self._encoding
+
+    def writable(self):
+        return True
+
+    def fileno(self):
+        return self._fd
+
+    def isatty(self):
+        return False
+
+    def write(self, text):
+        with self._pending_lock:
+            self._pending.append(text)
+            if "\n" in text:
+                self._flush_pending()
+        return len(text)
+
+    def flush(self):
+        with self._pending_lock:
+            self._flush_pending()
+
+    def _flush_pending(self):
+        """Send the pending text as frames. The caller holds _pending_lock."""
+        if not self._pending:
+            return
+        data = "".join(self._pending).encode(self._encoding, errors="replace")
+        self._pending.clear()
+        for start in range(0, len(data), MAX_PAYLOAD):
+            self.write_frame(self._channel, data[start:start + MAX_PAYLOAD])
+
+    def write_frame(self, channel, payload):
+        """Write one frame on any channel of this stream's descriptor."""
+        frame = encode_frame(channel, payload)
+        with self._lock:
+            while frame:
+                frame = frame[os.write(self._fd, frame):]
+
+def install_framed_stdio():
+    """Replace sys.stdout and sys.stderr with framed streams on the launcher's output pipes."""
+    import sys
+
+    if sys.stdout is None:
+        return  # No output pipe (started without the launcher exe)
+
+    fd = sys.stdout.fileno()
+    error_fd = sys.stderr.fileno() if sys.stderr is not None else fd
+    sys.stdout.flush()
+    if sys.stderr is not None:
+        sys.stderr.flush()
+
+    # stderr normally has its own pipe; only streams sharing a descriptor need to share a lock
+    lock = threading.Lock()
+    error_lock = lock if error_fd == fd else threading.Lock()
+    sys.stdout = FramedTextStream(fd, CHANNEL_LOG, lock)
+    sys.stderr = FramedTextStream(error_fd, CHANNEL_STDERR, error_lock)
@@ -0,0 +1,68 @@
+# launcher_metrics.py - queries the launcher exe's self-metrics.
+#   A "stats" control frame on stdout asks for them; the launcher answers on the command pipe
+#   with a control frame of "stats" followed by "name=value" lines (see Metrics.h).
+
+import threading
+
+from launcher_ipc import CHANNEL_CONTROL
+
+STATS_QUERY = b"stats"
+STATS_REPLY_PREFIX = "stats\n"
+
+# Counters shown by format_text, with their labels
+DISPLAY_COUNTERS = (
+    ("stdout_bytes_per_s", "Relay stdout", "B/s"),
+    ("stderr_bytes_per_s", "Relay stderr", "B/s"),
+    ("spawn_bytes_per_s", "Script output", "B/s"),
+    ("loop_iterations", "Loop iterations", ""),
+    ("stalls", "Stalls", ""),
+    ("longest_wakeup_us", "Longest wakeup", "us"),
+    ("command_write_failures", "Command pipe write failures", ""),
+    ("spawn_send_failures", "Script output send failures", ""),
+    ("connect_wait_ms", "Pipe connect wait", "ms"),
+    ("runs", "Launcher.py starts", ""),
+)
+
+class LauncherMetrics:
+    """Sends stats queries and keeps the launcher's latest answer."""
+    def __init__(self, write_frame):
+        self._write_frame = write_frame  # write_frame(channel, payload) on the launcher's output pipe
+        self._lock = threading.Lock()
+        self._latest = None
+
+    def request(self):
+        """Ask the launcher for its counters; the answer arrives on the command pipe reader."""
+        try:
+            self._write_frame(CHANNEL_CONTROL, STATS_QUERY)
+        except (OSError, ValueError):
+            pass
+
+    @staticmethod
+    def is_reply(command):
+        return command.startswith(STATS_REPLY_PREFIX)
+
+    def handle_reply(self, command):
+        """Store the counters of a stats reply."""
+        counters = {}
+        for line in command[len(STATS_REPLY_PREFIX):].splitlines():
+            name, _, value = line.partition("=")
+            if value.isdigit():
+                counters[name] = int(value)
+        with self._lock:
+            self._latest = counters
+
+    def latest(self):
+        """Return the counters of the latest reply, or None before the first one."""
+        with self._lock:
+            return self._latest
+
+    def format_text(self):
+        """Summarize the latest counters for the performance tab."""
+        counters = self.latest()
+        if counters is None:
+            return None
+        lines = ["Launcher Relay"]
+        for name, label, unit in DISPLAY_COUNTERS:
+            if name in counters:
+                lines.append(f"  {label}: {counters[name]:,}{' ' + unit if unit else ''}")
+        return "\n".join(lines) + "\n"
@@ -0,0 +1,235 @@
+# launcher_state.py - read access to the shared state block published by the launcher exe.
+#   The layout mirrors SharedState in Launcher/LauncherApp/Source/SharedState.h.
+
+import ctypes
+import mmap
+import struct
+import time
+
+SHARED_STATE_MAGIC = 0x5350534D  # "MSPS"
+
+# Field offsets (all fields are 32-bit little endian)
+OFFSET_MAGIC = 0
+OFFSET_VERSION = 4
+OFFSET_SIZE = 8
+OFFSET_HEARTBEAT = 12
+OFFSET_SHUTDOWN_REQUESTED = 16
+OFFSET_HEARTBEAT_INTERVAL_MS = 20
+OFFSET_LAUNCHER_PID = 24
+SHARED_STATE_V1_SIZE = 28
+
+# Version 2: job accounting (JobAccounting struct) guarded by a sequence counter
+OFFSET_ACCOUNTING_SEQUENCE = 28
+OFFSET_JOB_ACCOUNTING = 32
+JOB_ACCOUNTING_FORMAT = "<QQQQQIII"
+SHARED_STATE_V2_SIZE = 88
+
+# Version 3: telemetry table (TelemetryTable / TelemetryRecord in Telemetry.h)
+OFFSET_TELEMETRY = 88
+TELEMETRY_HEADER_FORMAT = "<IIII"    # sequence, sample_count, record_count, interval_ms
+TELEMETRY_RECORD_FORMAT = "<IIIIQQQ" # pid, parent_pid, cpu_percent_x100, reserved, cpu_time, working_set, private_bytes
+TELEMETRY_RECORDS_OFFSET = OFFSET_TELEMETRY + 16
+TELEMETRY_RECORD_SIZE = struct.calcsize(TELEMETRY_RECORD_FORMAT)
+
+# Version 4: interpreter pool table (PoolTable / PoolSlot in InterpreterPool.h)
+OFFSET_POOL = 2664
+OFFSET_POOL_WORKER_COUNT = OFFSET_POOL
+OFFSET_POOL_CLAIM_EVENT_NAME = OFFSET_POOL + 8
+POOL_CLAIM_EVENT_NAME_SIZE = 64
+POOL_SLOTS_OFFSET = OFFSET_POOL + 72
+POOL_SLOT_FORMAT = "<IIQQQ"          # state, pid, stdin_handle, stdout_handle, stderr_handle
+POOL_SLOT_SIZE = struct.calcsize(POOL_SLOT_FORMAT)
+POOL_MAX_WORKERS = 8
+
+# Version 5: start-up profiling marks (raw QueryPerformanceCounter values, 0 until reached)
+OFFSET_UI_MAIN_QPC = 2992
+OFFSET_UI_FIRST_FRAME_QPC = 3000
+
+# Version 6: UI heartbeat written by Launcher.py, watched by the launcher's hang detection
+OFFSET_UI_HEARTBEAT = 3008
+
+# Version 7: name of the event Launcher.py sets when its shutdown is complete
+OFFSET_SHUTDOWN_ACK_EVENT_NAME = 3016
+EVENT_NAME_SIZE = 64
+EVENT_MODIFY_STATE = 0x0002
+
+class SharedLauncherState:
+    """Maps the launcher's named shared state block and exposes its fields."""
+    def __init__(self, name):
+        self.name = name
+        self._map = mmap.mmap(-1, SHARED_STATE_V1_SIZE, tagname=name, access=mmap.ACCESS_WRITE)
+
+        if self._read_u32(OFFSET_MAGIC) != SHARED_STATE_MAGIC:
+            self._map.close()
+            raise ValueError(f"Shared state block '{name}' is not initialized")
+
+        # Remap at the size the launcher actually created
+        self.version = self._read_u32(OFFSET_VERSION)
+        size = self._read_u32(OFFSET_SIZE)
+        if size > SHARED_STATE_V1_SIZE:
+            self._map.close()
+            self._map = mmap.mmap(-1, size, tagname=name, access=mmap.ACCESS_WRITE)
+        self.heartbeat_interval = self._read_u32(OFFSET_HEARTBEAT_INTERVAL_MS) / 1000.0
+
+        # Heartbeat change tracking
+        self._last_heartbeat = self.heartbeat
+        self._last_heartbeat_change = time.monotonic()
+
+    def _read_u32(self, offset):
+        return struct.unpack_from("<I", self._map, offset)[0]
+
+    def _read_name(self, offset, size):
+        """Read a NUL terminated ASCII name, None if empty."""
+        raw = self._map[offset:offset + size]
+        return raw.split(b"\0", 1)[0].decode("ascii") or None
+
+    @property
+    def heartbeat(self):
+        """Current heartbeat counter value."""
+        return self._read_u32(OFFSET_HEARTBEAT)
+
+    @property
+    def shutdown_requested(self):
+        """True once the launcher has asked the UI to shut down."""
+        return self._read_u32(OFFSET_SHUTDOWN_REQUESTED) != 0
+
+    @property
+    def launcher_pid(self):
+        """Process ID of the launcher exe."""
+        return self._read_u32(OFFSET_LAUNCHER_PID)
+
+    def job_accounting(self):
+        """
+        Return the launcher's job accounting totals for the whole Python tree, or None if the
+        launcher does not publish them. CPU times are in seconds, sizes in bytes.
+        """
+        if self.version < 2:
+            return None
+
+        # Sequence lock: retry while the launcher is mid-update
+        for _ in range(10):
+            before = self._read_u32(OFFSET_ACCOUNTING_SEQUENCE)
+            if before & 1:
+                continue
+            values = struct.unpack_from(JOB_ACCOUNTING_FORMAT, self._map, OFFSET_JOB_ACCOUNTING)
+            if self._read_u32(OFFSET_ACCOUNTING_SEQUENCE) == before:
+                break
+        else:
+            return None
+
+        user, kernel, peak_memory, io_read, io_write, active, total, terminated = values
+        return {
+            "user_time": user / 1e7,
+            "kernel_time": kernel / 1e7,
+            "peak_memory": peak_memory,
+            "io_read_bytes": io_read,
+            "io_write_bytes": io_write,
+            "active_processes": active,
+            "total_processes": total,
+            "terminated_processes": terminated,
+        }
+
+    def telemetry(self):
+        """
+        Return the latest per-process telemetry sample as (sample_count, interval_ms, records),
+        or None if the launcher does not publish telemetry. Each record is a dict keyed by field name with
+        cpu_percent as percent of one core, memory values in bytes.
+        """
+        if self.version < 3:
+            return None
+
+        for _ in range(10):
+            sequence, sample_count, record_count, interval_ms = struct.unpack_from(
+                TELEMETRY_HEADER_FORMAT, self._map, OFFSET_TELEMETRY)
+            if sequence & 1:
+                continue
+            if interval_ms == 0:
+                return None
+
+            records = []
+            for i in range(record_count):
+                pid, parent_pid, cpu_x100, _, cpu_time, working_set, private_bytes = struct.unpack_from(
+                    TELEMETRY_RECORD_FORMAT, self._map, TELEMETRY_RECORDS_OFFSET + i * TELEMETRY_RECORD_SIZE)
+                records.append({
+                    "pid": pid,
+                    "parent_pid": parent_pid,
+                    "cpu_percent": cpu_x100 / 100.0,
+                    "cpu_time": cpu_time / 1e7,
+                    "working_set": working_set,
+                    "private_bytes": private_bytes,
+                })
+
+            if self._read_u32(OFFSET_TELEMETRY) == sequence:
+                return sample_count, interval_ms, records
+        return None
+
+    def pool_slots(self):
+        """
+        Return the interpreter pool slots as (state, pid, stdin_handle, stdout_handle,
+        stderr_handle) tuples, or an empty list if the launcher runs no pool.
+        """
+        if self.version < 4:
+            return []
+        count = min(self._read_u32(OFFSET_POOL_WORKER_COUNT), POOL_MAX_WORKERS)
+        return [struct.unpack_from(POOL_SLOT_FORMAT, self._map, POOL_SLOTS_OFFSET + i * POOL_SLOT_SIZE)
+                for i in range(count)]
+
+    def set_pool_slot_state(self, index, state):
+        """Write the state word of one pool slot."""
+        struct.pack_into("<I", self._map, POOL_SLOTS_OFFSET + index * POOL_SLOT_SIZE, state)
+
+    def pool_claim_event_name(self):
+        """Name of the event the launcher waits on for pool claims, or None without a pool."""
+        if self.version < 4:
+            return None
+        return self._read_name(OFFSET_POOL_CLAIM_EVENT_NAME, POOL_CLAIM_EVENT_NAME_SIZE)
+
+    def _mark_startup(self, offset):
+        """Store the current QPC value at offset unless it was already set."""
+        if self.version < 5 or struct.unpack_from("<Q", self._map, offset)[0]:
+            return
+        counter = ctypes.c_longlong()
+        ctypes.windll.kernel32.QueryPerformanceCounter(ctypes.byref(counter))
+        struct.pack_into("<q", self._map, offset, counter.value)
+
+    def mark_ui_main(self):
+        """Record for --profile-startup that Launcher.py has finished importing and entered main."""
+        self._mark_startup(OFFSET_UI_MAIN_QPC)
+
+    def mark_first_frame(self):
+        """Record for --profile-startup that the first Tk frame has been drawn."""
+        self._mark_startup(OFFSET_UI_FIRST_FRAME_QPC)
+
+    def beat_ui(self):
+        """Advance the UI heartbeat; call from the Tk loop so a hung loop stops the count."""
+        if self.version < 6:
+            return
+        value = (self._read_u32(OFFSET_UI_HEARTBEAT) + 1) & 0x7FFFFFFF or 1  # Never back to 0
+        struct.pack_into("<I", self._map, OFFSET_UI_HEARTBEAT, value)
+
+    def acknowledge_shutdown(self):
+        """Tell the launcher that shutdown is complete so it stops waiting on its deadline."""
+        if self.version < 7:
+            return
+        name = self._read_name(OFFSET_SHUTDOWN_ACK_EVENT_NAME, EVENT_NAME_SIZE)
+        if not name:
+            return
+        kernel32 = ctypes.windll.kernel32
+        kernel32.OpenEventW.restype = ctypes.c_void_p
+        event = kernel32.OpenEventW(EVENT_MODIFY_STATE, False, name)
+        if event:
+            kernel32.SetEvent(ctypes.c_void_p(event))
+            kernel32.CloseHandle(ctypes.c_void_p(event))
+
+    def seconds_since_heartbeat(self):
+        """Seconds since the heartbeat counter was last seen to change."""
+        now = time.monotonic()
+        current = self.heartbeat
+        if current != self._last_heartbeat:
+            self._last_heartbeat = current
+            self._last_heartbeat_change = now
+        return now - self._last_heartbeat_change
+
+    def close(self):
+        """Unmap the shared state block."""
+        self._map.close()
@@ -1,5 +1,17 @@
 # parse_ansi.py - used to parse ANSI escape sequences in text and apply colors and styles to the text.
 #   This is for displaying colored text in ScriptTab.
+
+# Style IDs of text the launcher exe has already parsed (Launcher/LauncherApp/Source/SgrParser.h):
+#   the low nibble is the color (0 default, 1-8 for codes 30-37), bit 4 is bold
+STYLE_COLOR_MASK = 0x0F
+STYLE_BOLD = 0x10
+
+def style_from_id(style_id):
+    """Return the (color, bold) of a style ID sent by the launcher exe."""
+    color_index = style_id & STYLE_COLOR_MASK
+    color = AnsiParser.ANSI_COLOR_MAP.get(str(29 + color_index)) if color_index else None
+    return color, bool(style_id & STYLE_BOLD)
+
 class AnsiParser:
     ANSI_COLOR_MAP = {
         '30': '#000000', '31': '#FF0000', '32': '#00FF00', '33': '#FFFF00',
@@ -0,0 +1,54 @@
+# pool_worker.py - idle interpreter kept warm by the launcher exe's interpreter pool.
+#   Imports the common modules up front, then waits for one JSON request on stdin naming the
+#   script to run. The script runs in this process as __main__, so it skips interpreter and
+#   import start-up. Started by InterpreterPool.c, handed out by interpreter_pool.py.
+
+import argparse
+import importlib
+import json
+import os
+import runpy
+import sys
+
+def preload(modules):
+    """Import the given modules, ignoring any that are not installed."""
+    for name in filter(None, (m.strip() for m in modules.split(","))):
+        try:
+            importlib.import_module(name)
+        except Exception:
+            pass
+
+def apply_request(request):
+    """Set up argv, path, environment and working directory the way a fresh interpreter would."""
+    script = request["script"]
+
+    os.environ.update(request.get("env", {}))
+    for entry in reversed(request.get("path", [])):
+        if entry and entry not in sys.path:
+            sys.path.insert(0, entry)
+    if request.get("cwd"):
+        os.chdir(request["cwd"])
+
+    # A script run directly has its own directory first on sys.path
+    sys.path.insert(0, os.path.dirname(os.path.abspath(script)))
+    sys.argv = [script] + list(request.get("args", []))
+    return script
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--preload", default="")
+    args = parser.parse_args()
+
+    preload(args.preload)
+
+    # Block until the UI claims this worker; EOF means the pool is shutting down
+    line = sys.stdin.readline()
+    if not line:
+        return
+
+    script = apply_request(json.loads(line))
+    sys.argv[0] = script
+    runpy.run_path(script, run_name="__main__")
+
+if __name__ == "__main__":
+    main()
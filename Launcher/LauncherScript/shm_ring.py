@@ -0,0 +1,106 @@
+# shm_ring.py - reader of the shared-memory ring the launcher exe writes spawn service records to.
+#   The layout mirrors ShmRingHeader in Launcher/LauncherApp/Source/ShmRing.h.
+
+import ctypes
+import mmap
+import struct
+
+SHM_RING_MAGIC = 0x474E5253  # "SRNG"
+
+# Header field offsets
+OFFSET_MAGIC = 0
+OFFSET_VERSION = 4
+OFFSET_CAPACITY = 8
+OFFSET_HEADER_SIZE = 12
+OFFSET_EVENT_NAME = 16
+EVENT_NAME_SIZE = 64
+OFFSET_WRITE_POS = 128       # 64-bit, written by the launcher
+OFFSET_READ_POS = 192        # 64-bit, written by this reader
+OFFSET_CONSUMER_WAITING = 200
+HEADER_SIZE = 256
+
+SYNCHRONIZE = 0x00100000
+WAIT_OBJECT_0 = 0
+
+class ShmRingReader:
+    """
+    Reads the length-prefixed records of the launcher's ring. Only one reader may use a ring,
+    the positions are not shared between readers.
+    """
+    def __init__(self, name):
+        self.name = name
+        self._map = mmap.mmap(-1, HEADER_SIZE, tagname=name, access=mmap.ACCESS_WRITE)
+        if struct.unpack_from("<I", self._map, OFFSET_MAGIC)[0] != SHM_RING_MAGIC:
+            self._map.close()
+            raise ValueError(f"Ring '{name}' is not initialized")
+
+        # Remap to include the data area
+        self.capacity, header_size = struct.unpack_from("<II", self._map, OFFSET_CAPACITY)
+        raw = self._map[OFFSET_EVENT_NAME:OFFSET_EVENT_NAME + EVENT_NAME_SIZE]
+        event_name = raw.split(b"\0", 1)[0].decode("ascii")
+        self._map.close()
+        self._map = mmap.mmap(-1, header_size + self.capacity, tagname=name, access=mmap.ACCESS_WRITE)
+        self._data_offset = header_size
+
+        # Aligned 64-bit loads and stores through ctypes are single instructions, so the
+        # positions never tear
+        self._write_pos = ctypes.c_int64.from_buffer(self._map, OFFSET_WRITE_POS)
+        self._read_pos = ctypes.c_int64.from_buffer(self._map, OFFSET_READ_POS)
+        self._waiting = ctypes.c_int32.from_buffer(self._map, OFFSET_CONSUMER_WAITING)
+
+        kernel32 = ctypes.windll.kernel32
+        kernel32.OpenEventW.restype = ctypes.c_void_p
+        kernel32.WaitForSingleObject.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+        kernel32.CloseHandle.argtypes = [ctypes.c_void_p]
+        self._kernel32 = kernel32
+        self._event = kernel32.OpenEventW(SYNCHRONIZE, False, event_name)
+        if not self._event:
+            self.close()
+            raise OSError(f"Failed to open the wakeup event of ring '{name}'")
+
+    def _copy_out(self, position, length):
+        """Bytes of the data area at a position, joined across the wrap."""
+        offset = self._data_offset + (position & (self.capacity - 1))
+        end = self._data_offset + self.capacity
+        if offset + length <= end:
+            return self._map[offset:offset + length]
+        first = end - offset
+        return self._map[offset:end] + self._map[self._data_offset:self._data_offset + length - first]
+
+    def pending(self):
+        """True when records are waiting."""
+        return self._write_pos.value != self._read_pos.value
+
+    def read_batch(self):
+        """Return the payloads of all published records and free their space."""
+        write_pos = self._write_pos.value
+        position = self._read_pos.value
+        payloads = []
+        while position < write_pos:
+            length = struct.unpack("<I", self._copy_out(position, 4))[0]
+            payloads.append(self._copy_out(position + 4, length))
+            position += (4 + length + 3) & ~3
+        if payloads:
+            self._read_pos.value = position
+        return payloads
+
+    def wait(self, timeout):
+        """
+        Sleep until the launcher publishes a record or timeout seconds pass. A wakeup lost to
+        the flag race only costs the timeout.
+        """
+        self._waiting.value = 1
+        if not self.pending():
+            self._kernel32.WaitForSingleObject(self._event, int(timeout * 1000))
+        self._waiting.value = 0
+
+    def close(self):
+        """Unmap the ring and close the wakeup event."""
+        # The ctypes views pin the buffer, so they go before the map
+        for view in ("_write_pos", "_read_pos", "_waiting"):
+            if hasattr(self, view):
+                delattr(self, view)
+        if getattr(self, "_event", None):
+            self._kernel32.CloseHandle(self._event)
+            self._event = None
+        self._map.close()
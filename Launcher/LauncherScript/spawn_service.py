@@ -0,0 +1,227 @@
+# spawn_service.py - starts scripts through the launcher exe instead of subprocess.
+#   Mirrors Launcher/LauncherApp/Source/SpawnService.h. Requests go out as CHANNEL_SPAWN frames
+#   on stdout; replies and script output come back as CHANNEL_SPAWN frames on the command pipe
+#   and are handled on the command pipe reader thread, so no threads are needed per script.
+
+import codecs
+import struct
+import subprocess
+import threading
+import _winapi
+
+from launcher_ipc import CHANNEL_SPAWN
+
+STREAM_STDOUT = 1
+STREAM_STDERR = 2
+
+# One style run of a "styled" reply: offset, length, style ID (SGR_RUN_SIZE in SgrParser.h)
+RUN_FORMAT = struct.Struct("<HHB")
+
+PROCESS_SYNCHRONIZE_QUERY = 0x00100000 | 0x1000 | 0x0001  # SYNCHRONIZE, QUERY_LIMITED_INFORMATION, TERMINATE
+STILL_ACTIVE = 259
+
+# How long spawn() waits for the launcher to report the new process
+SPAWN_REPLY_TIMEOUT = 5.0
+
+class ServiceInput:
+    """Stands in for a script's stdin queue: put_nowait() forwards text, None closes stdin."""
+    def __init__(self, service, script_id):
+        self._service = service
+        self._id = script_id
+
+    def put_nowait(self, text):
+        if text is None:
+            self._service.send(f"close {self._id}".encode("utf-8"))
+        elif text:
+            self._service.send(f"input {self._id}\n".encode("utf-8") + text.encode("utf-8"))
+
+    put = put_nowait
+
+class ServiceProcess:
+    """A script started by the launcher, exposing the parts of subprocess.Popen used by ProcessTracker."""
+    def __init__(self, pid):
+        self.pid = pid
+        self.args = None
+        self.returncode = None
+        self.stdin = None
+        self.stdout = None  # Output arrives through the spawn service callbacks
+        self.stderr = None
+        self._handle = _winapi.OpenProcess(PROCESS_SYNCHRONIZE_QUERY, False, pid)
+
+    def poll(self):
+        """Return the exit code, or None while the script is running."""
+        if self.returncode is None:
+            code = _winapi.GetExitCodeProcess(self._handle)
+            if code != STILL_ACTIVE or _winapi.WaitForSingleObject(self._handle, 0) == _winapi.WAIT_OBJECT_0:
+                self.returncode = code
+        return self.returncode
+
+    def wait(self, timeout=None):
+        """Wait for the script to exit and return its exit code."""
+        milliseconds = _winapi.INFINITE if timeout is None else int(timeout * 1000)
+        if _winapi.WaitForSingleObject(self._handle, milliseconds) != _winapi.WAIT_OBJECT_0:
+            raise TimeoutError(f"Process {self.pid} did not exit within {timeout} seconds")
+        return self.poll()
+
+    def terminate(self):
+        """Terminate the script if it is still running."""
+        if self.poll() is None:
+            _winapi.TerminateProcess(self._handle, 1)
+
+    kill = terminate
+
+class _Script:
+    """Bookkeeping for one script started through the service."""
+    def __init__(self, on_stdout, on_stderr, on_styled, on_trace):
+        self.callbacks = {STREAM_STDOUT: on_stdout, STREAM_STDERR: on_stderr}
+        self.on_styled = on_styled
+        self.on_trace = on_trace
+        # Chunks can end inside a UTF-8 sequence, so each stream keeps a decoder
+        self.decoders = {stream: codecs.getincrementaldecoder("utf-8")(errors="replace")
+                         for stream in self.callbacks}
+        self.started = threading.Event()
+        self.pid = None
+        self.error = None
+
+class SpawnService:
+    """Client of the launcher's spawn service."""
+    def __init__(self, write_frame):
+        self._write_frame = write_frame  # write_frame(channel, payload) on the launcher's output pipe
+        self._lock = threading.Lock()
+        self._next_id = 1
+        self._scripts = {}
+
+    def send(self, payload):
+        """Send one request to the launcher."""
+        self._write_frame(CHANNEL_SPAWN, payload)
+
+    def spawn(self, command, on_stdout, on_stderr, env=None, cwd=None, on_styled=None, on_trace=None):
+        """
+        Start command (a list, as for Popen) through the launcher. on_stdout and on_stderr are
+        called with decoded text on the command pipe reader thread. When the launcher parses
+        escape codes itself, on_styled gets a list of (text, style ID) segments instead (see
+        parse_ansi.style_from_id). on_trace(stream, sequence, qpc) is called before each output
+        frame is delivered with the stamp the launcher gave it. Returns (ServiceProcess,
+        ServiceInput), or None if the launcher could not start it (the caller then falls back
+        to subprocess).
+        """
+        with self._lock:
+            script_id = self._next_id
+            self._next_id += 1
+            script = _Script(on_stdout, on_stderr, on_styled, on_trace)
+            self._scripts[script_id] = script
+
+        try:
+            # UTF-8 throughout; the launcher starts the script with CreateProcessW
+            environment = b""
+            if env:
+                environment = b"".join(f"{key}={value}".encode("utf-8") + b"\0" for key, value in env.items())
+            request = (f"spawn {script_id}\n{cwd or ''}\n{subprocess.list2cmdline(command)}\n".encode("utf-8")
+                       + environment)
+            self.send(request)
+        except (OSError, ValueError) as e:  # UnicodeEncodeError (lone surrogates) is a ValueError
+            print(f"[WARNING] Spawn service request failed: {e}")
+            self._forget(script_id)
+            return None
+
+        if not script.started.wait(SPAWN_REPLY_TIMEOUT):
+            print("[WARNING] Spawn service did not answer in time, giving up on its copy of the script.")
+            self._abandon(script_id)
+            return None
+        if script.error is not None:
+            print(f"[WARNING] Spawn service could not start script (error {script.error}).")
+            self._forget(script_id)
+            return None
+
+        try:
+            process = ServiceProcess(script.pid)
+        except OSError as e:
+            print(f"[WARNING] Could not open spawned process {script.pid}: {e}")
+            self._abandon(script_id)
+            return None
+        return process, ServiceInput(self, script_id)
+
+    def handle_frame(self, payload):
+        """Handle one CHANNEL_SPAWN frame from the command pipe."""
+        header, _, data = payload.partition(b"\n")
+        parts = header.decode("ascii", errors="replace").split()
+        if len(parts) < 2 or not parts[1].isdigit():
+            return
+
+        kind, script_id = parts[0], int(parts[1])
+        with self._lock:
+            script = self._scripts.get(script_id)
+        if script is None:
+            return
+
+        if kind == "out" and len(parts) == 5:
+            stream = int(parts[2])
+            callback = script.callbacks.get(stream)
+            if callback:
+                text = script.decoders[stream].decode(data)
+                if text:
+                    if script.on_trace:
+                        script.on_trace(stream, int(parts[3]), int(parts[4]))
+                    callback(text)
+        elif kind == "styled" and len(parts) == 6:
+            self._handle_styled(script, int(parts[2]), int(parts[3]), data, int(parts[4]), int(parts[5]))
+        elif kind == "started" and len(parts) == 3:
+            script.pid = int(parts[2])
+            script.started.set()
+        elif kind == "failed":
+            script.error = parts[2] if len(parts) == 3 else "unknown"
+            script.started.set()
+        elif kind == "exited":
+            # The launcher sends this after the script's last output
+            for stream, decoder in script.decoders.items():
+                text = decoder.decode(b"", final=True)
+                if text:
+                    script.callbacks[stream](text)
+            self._forget(script_id)
+
+    def _handle_styled(self, script, stream, run_count, data, sequence, qpc):
+        """Decode the text and style runs of a "styled" reply."""
+        decoder = script.decoders.get(stream)
+        if decoder is None:
+            return
+        table_size = run_count * RUN_FORMAT.size
+        table, text = data[:table_size], data[table_size:]
+
+        # The decoder carries characters split across runs and frames
+        segments = []
+        for offset, length, style_id in RUN_FORMAT.iter_unpack(table):
+            segment = decoder.decode(text[offset:offset + length])
+            if segment:
+                segments.append((segment, style_id))
+        if not segments:
+            return
+
+        if script.on_trace:
+            script.on_trace(stream, sequence, qpc)
+        if script.on_styled:
+            script.on_styled(segments)
+        else:
+            script.callbacks[stream]("".join(segment for segment, _ in segments))
+
+    def _forget(self, script_id):
+        with self._lock:
+            self._scripts.pop(script_id, None)
+
+    def _abandon(self, script_id):
+        """Stop a script the caller will start again itself, in case the launcher started it."""
+        self._forget(script_id)
+        try:
+            self.send(f"kill {script_id}".encode("utf-8"))
+        except (OSError, ValueError):
+            pass
+
+class CallbackQueue:
+    """Stands in for a script's output queue: put() hands text straight to a callback."""
+    def __init__(self, callback):
+        self._callback = callback
+
+    def put_nowait(self, text):
+        if text is not None:  # None is the end-of-stream sentinel of a real queue
+            self._callback(text)
+
+    put = put_nowait